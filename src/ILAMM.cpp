@@ -1,7 +1,19 @@
 # include <RcppArmadillo.h>
+# include <atomic>
+# include <chrono>
 # include <cmath>
+# include <cstdint>
+# include <cstdio>
+# include <fstream>
 # include <iostream>
+# include <random>
+# include <stdexcept>
 # include <string>
+# include <thread>
+# include <vector>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
 // [[Rcpp::depends(RcppArmadillo)]]
 
 // [[Rcpp::export]]
@@ -42,41 +54,196 @@ arma::vec cmptLambda(const arma::vec& beta, const double lambda, const std::stri
   return rst;
 }
 
+// Column means and scales of X in a single pass, the first column is the intercept and is left
+// untouched. If center is false, the scale is the root mean square of the column. If rows isn't
+// empty, they're the ones of the index view X[rows, ], see cmptXBeta.
+void cmptColScale(const arma::mat& X, const arma::uvec& rows, arma::vec& colMean,
+                  arma::vec& colScale, const bool center) {
+  bool view = !rows.is_empty();
+  int n = view ? rows.size() : X.n_rows;
+  colMean = arma::zeros(X.n_cols);
+  colScale = arma::ones(X.n_cols);
+  for (int j = 1; j < (int)X.n_cols; j++) {
+    const double* col = X.colptr(j);
+    double m = 0, s = 0;
+    for (int i = 0; i < n; i++) {
+      double x = col[view ? rows(i) : i];
+      double delta = x - m;
+      m += delta / (i + 1);
+      s += delta * (x - m);
+    }
+    double ms = center ? s / n : s / n + m * m;
+    if (center) {
+      colMean(j) = m;
+    }
+    if (ms > 0) {
+      colScale(j) = std::sqrt(ms);
+    }
+  }
+}
+
+// Number of threads of the row-parallel kernels, see setThreads
+static std::atomic<int> kernelThreads(1);
+
+// Number of threads for a kernel over m rows (or columns). It's 1 inside a parallel region, e.g.
+// in bootNcvxHuberReg, or if each thread would get fewer than 1024 rows.
+int cmptThreads(const int m) {
+#ifdef _OPENMP
+  if (omp_in_parallel()) {
+    return 1;
+  }
+  return std::max(1, std::min(kernelThreads.load(), m / 1024));
+#else
+  return 1;
+#endif
+}
+
+//' The function sets the number of threads of the loss, gradient and product kernels inside every fit of the package.
+//'
+//' With one thread, the products with \eqn{X} are done by BLAS, so a multithreaded BLAS is used as it is. With more threads, the rows of \eqn{X} are split into one block per thread, the partial gradient of each block is accumulated separately, and the partial gradients are summed in the order of the blocks, so the result only depends on the number of threads, even if the system starts fewer of them. Then the kernels don't call BLAS, and BLAS should be limited to one thread (e.g. by \code{RhpcBLASctl::blas_set_num_threads(1)}) to avoid oversubscription, the package doesn't change the number of BLAS threads. Fits that run in parallel with each other, as in \code{bootNcvxHuberReg}, always use one thread per fit. It's ignored if the package is built without OpenMP.
+//'
+//' @title Number of threads of the kernels
+//' @param nthreads The number of threads, non-positive values mean the OpenMP default, usually the number of cores. The default value of the package is 1.
+//' @return The previous number of threads.
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @examples
+//' old = setThreads(2)
+//' setThreads(old)
+//' @export
+// [[Rcpp::export]]
+int setThreads(int nthreads) {
+#ifdef _OPENMP
+  if (nthreads <= 0) {
+    nthreads = omp_get_max_threads();
+  }
+#endif
+  return kernelThreads.exchange(std::max(nthreads, 1));
+}
+
+// X_s * beta with X_s = (X - 1 * colMean^T) * diag(1 / colScale), without forming X_s. If rows
+// isn't empty, X is the index view X[rows, ] (repeats allowed), which is gathered column by column
+// over the nonzero coefficients only, so subsample fits share X instead of copying it. With more
+// than one thread, the rows are split into nt blocks, which are shared by the threads OpenMP
+// actually starts, so every block is done even if it starts fewer.
+arma::vec cmptXBeta(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                    const arma::vec& colScale, const arma::vec& beta) {
+  arma::vec betaS = beta / colScale;
+  double shift = arma::dot(colMean, betaS);
+  bool view = !rows.is_empty();
+  int m = view ? rows.size() : X.n_rows;
+  int nt = cmptThreads(m);
+  if (!view && nt == 1) {
+    return X * betaS - shift;
+  }
+  arma::uvec nonzero = arma::find(betaS);
+  arma::vec rst = arma::vec(m);
+  rst.fill(-shift);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+  for (int t = 0; t < nt; t++) {
+    int low = (int)((long long)m * t / nt);
+    int up = (int)((long long)m * (t + 1) / nt);
+    for (int k = 0; k < (int)nonzero.size(); k++) {
+      const double* col = X.colptr(nonzero(k));
+      double b = betaS(nonzero(k));
+      for (int i = low; i < up; i++) {
+        rst(i) += col[view ? rows(i) : i] * b;
+      }
+    }
+  }
+  return rst;
+}
+
+// X_s^T * res, without forming X_s, see cmptXBeta for rows and blocks. The partial product of each
+// block of rows is summed in the block order.
+arma::vec cmptXtRes(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                    const arma::vec& colScale, const arma::vec& res) {
+  bool view = !rows.is_empty();
+  int m = res.size();
+  int nt = cmptThreads(m);
+  arma::vec rst = arma::vec(X.n_cols);
+  if (!view && nt == 1) {
+    rst = X.t() * res;
+  } else {
+    arma::mat partial = arma::zeros(X.n_cols, nt);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+    for (int t = 0; t < nt; t++) {
+      int low = (int)((long long)m * t / nt);
+      int up = (int)((long long)m * (t + 1) / nt);
+      for (int j = 0; j < (int)X.n_cols; j++) {
+        const double* col = X.colptr(j);
+        double s = 0;
+        for (int i = low; i < up; i++) {
+          s += col[view ? rows(i) : i] * res(i);
+        }
+        partial(j, t) = s;
+      }
+    }
+    rst = arma::sum(partial, 1);
+  }
+  return (rst - colMean * arma::accu(res)) / colScale;
+}
+
+// Map the coefficients of the standardized design back to the original scale
+// [[Rcpp::export]]
+arma::vec unscaleBeta(const arma::vec& beta, const arma::vec& colMean, const arma::vec& colScale) {
+  arma::vec rst = beta / colScale;
+  rst(0) -= arma::dot(colMean, rst);
+  return rst;
+}
+
+// Inverse of unscaleBeta, map coefficients on the original scale to the standardized design
+// [[Rcpp::export]]
+arma::vec scaleBeta(const arma::vec& beta, const arma::vec& colMean, const arma::vec& colScale) {
+  arma::vec rst = beta % colScale;
+  rst(0) += arma::dot(colMean, beta);
+  return rst;
+}
+
+// The loss is summed by blocks of rows in parallel as in cmptXtRes
 // [[Rcpp::export]]
 double loss(const arma::vec& Y, const arma::vec& Ynew, const std::string lossType,
             const double tau) {
-  double rst = 0;
-  if (lossType == "l2") {
-    rst = arma::mean(arma::square(Y - Ynew)) / 2;
-  } else if (lossType == "Huber") {
-    arma::vec res = Y - Ynew;
-    for (int i = 0; i < (int)Y.size(); i++) {
-      if (std::abs(res(i)) <= tau) {
-        rst += res(i) * res(i) / 2;
+  int n = Y.size();
+  int nt = cmptThreads(n);
+  if (lossType == "l2" && nt == 1) {
+    return arma::mean(arma::square(Y - Ynew)) / 2;
+  }
+  bool huber = lossType == "Huber";
+  arma::vec partial = arma::zeros(nt);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+  for (int t = 0; t < nt; t++) {
+    int low = (int)((long long)n * t / nt);
+    int up = (int)((long long)n * (t + 1) / nt);
+    double s = 0;
+    for (int i = low; i < up; i++) {
+      double res = Y(i) - Ynew(i);
+      if (!huber || std::abs(res) <= tau) {
+        s += res * res / 2;
       } else {
-        rst += tau * std::abs(res(i)) - tau * tau / 2;
+        s += tau * std::abs(res) - tau * tau / 2;
       }
     }
-    rst /= Y.size();
+    partial(t) = s;
   }
-  return rst;
+  return arma::accu(partial) / n;
 }
 
-// [[Rcpp::export]]
-arma::vec gradLoss(const arma::mat& X, const arma::vec& Y, const arma::vec& beta,
+arma::vec gradLoss(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                   const arma::vec& colScale, const arma::vec& Y, const arma::vec& beta,
                    const std::string lossType, const double tau, const bool interecept) {
-  arma::vec res = Y - X * beta;
+  arma::vec res = Y - cmptXBeta(X, rows, colMean, colScale, beta);
   arma::vec rst = arma::zeros(beta.size());
   if (lossType == "l2") {
-    rst = -1 * (res.t() * X).t();
+    rst = -1 * cmptXtRes(X, rows, colMean, colScale, res);
   } else if (lossType == "Huber") {
-    for (int i = 0; i < (int)Y.size(); i++) {
-      if (std::abs(res(i)) <= tau) {
-        rst -= res(i) * X.row(i).t();
-      } else {
-        rst -= tau * sgn(res(i)) * X.row(i).t();
-      }
-    }
+    arma::vec psi = arma::clamp(res, -tau, tau);
+    rst = -1 * cmptXtRes(X, rows, colMean, colScale, psi);
   }
   if (!interecept) {
     rst(0) = 0;
@@ -84,48 +251,507 @@ arma::vec gradLoss(const arma::mat& X, const arma::vec& Y, const arma::vec& beta
   return rst / Y.size();
 }
 
+// The exported kernels keep their signatures on the whole X without standardization
+// [[Rcpp::export]]
+arma::vec gradLoss(const arma::mat& X, const arma::vec& Y, const arma::vec& beta,
+                   const std::string lossType, const double tau, const bool interecept) {
+  return gradLoss(X, arma::uvec(), arma::zeros(X.n_cols), arma::ones(X.n_cols), Y, beta,
+                  lossType, tau, interecept);
+}
+
+arma::vec updateBeta(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                     const arma::vec& colScale, const arma::vec& Y, arma::vec beta,
+                     const double phi, const arma::vec& Lambda, const std::string lossType,
+                     const double tau, const bool intercept) {
+  arma::vec first = beta - gradLoss(X, rows, colMean, colScale, Y, beta, lossType, tau,
+                                    intercept) / phi;
+  arma::vec second = Lambda / phi;
+  return softThresh(first, second);
+}
+
 // [[Rcpp::export]]
 arma::vec updateBeta(const arma::mat& X, const arma::vec& Y, arma::vec beta, const double phi,
                      const arma::vec& Lambda, const std::string lossType, const double tau,
                      const bool intercept) {
-  arma::vec first = beta - gradLoss(X, Y, beta, lossType, tau, intercept) / phi;
-  arma::vec second = Lambda / phi;
-  return softThresh(first, second);
+  return updateBeta(X, arma::uvec(), arma::zeros(X.n_cols), arma::ones(X.n_cols), Y, beta, phi,
+                    Lambda, lossType, tau, intercept);
+}
+
+double cmptF(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+             const arma::vec& colScale, const arma::vec& Y, const arma::vec& betaNew,
+             const std::string lossType, const double tau) {
+  return loss(Y, cmptXBeta(X, rows, colMean, colScale, betaNew), lossType, tau);
 }
 
 // [[Rcpp::export]]
 double cmptF(const arma::mat& X, const arma::vec& Y, const arma::vec& betaNew,
              const std::string lossType, const double tau) {
-  return loss(Y, X * betaNew, lossType, tau);
+  return cmptF(X, arma::uvec(), arma::zeros(X.n_cols), arma::ones(X.n_cols), Y, betaNew,
+               lossType, tau);
 }
 
-// [[Rcpp::export]]
-double cmptPsi(const arma::mat& X, const arma::vec& Y, const arma::vec& betaNew,
+double cmptPsi(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+               const arma::vec& colScale, const arma::vec& Y, const arma::vec& betaNew,
                const arma::vec& beta, const double phi, const std::string lossType,
                const double tau, const bool intercept) {
   arma::vec diff = betaNew - beta;
-  double rst = loss(Y, X * beta, lossType, tau)
-    + arma::as_scalar((gradLoss(X, Y, beta, lossType, tau, intercept)).t() * diff)
+  double rst = loss(Y, cmptXBeta(X, rows, colMean, colScale, beta), lossType, tau)
+    + arma::as_scalar((gradLoss(X, rows, colMean, colScale, Y, beta, lossType, tau,
+                                intercept)).t() * diff)
     + phi * arma::as_scalar(diff.t() * diff) / 2;
   return rst;
 }
 
+// [[Rcpp::export]]
+double cmptPsi(const arma::mat& X, const arma::vec& Y, const arma::vec& betaNew,
+               const arma::vec& beta, const double phi, const std::string lossType,
+               const double tau, const bool intercept) {
+  return cmptPsi(X, arma::uvec(), arma::zeros(X.n_cols), arma::ones(X.n_cols), Y, betaNew, beta,
+                 phi, lossType, tau, intercept);
+}
+
+// The maximal number of inflations of phi in one line search of LAMM
+const int backtrackMax = 1000;
+
+// One LAMM step from beta written to betaNew, returns the inflated phi. The line search gives up
+// after backtrackMax inflations or on non-finite values, then betaNew = beta and -1 is returned.
+double proxLAMM(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                const arma::vec& colScale, const arma::vec& Y, const arma::vec& Lambda,
+                const arma::vec& beta, arma::vec& betaNew, const double phi,
+                const std::string lossType, const double tau, const double gamma,
+                const bool intercept) {
+  double phiNew = phi;
+  for (int k = 0; k <= backtrackMax; k++) {
+    betaNew = updateBeta(X, rows, colMean, colScale, Y, beta, phiNew, Lambda, lossType, tau,
+                         intercept);
+    double FVal = cmptF(X, rows, colMean, colScale, Y, betaNew, lossType, tau);
+    double PsiVal = cmptPsi(X, rows, colMean, colScale, Y, betaNew, beta, phiNew, lossType, tau,
+                            intercept);
+    if (!std::isfinite(FVal) || !std::isfinite(PsiVal)) {
+      break;
+    }
+    if (FVal <= PsiVal) {
+      return phiNew;
+    }
+    phiNew *= gamma;
+  }
+  betaNew = beta;
+  return -1;
+}
+
 // [[Rcpp::export]]
 Rcpp::List LAMM(const arma::mat& X, const arma::vec& Y, const arma::vec& Lambda, arma::vec beta,
                 const double phi, const std::string lossType, const double tau,
                 const double gamma, const bool interecept) {
-  double phiNew = phi;
   arma::vec betaNew = arma::vec();
-  while (true) {
-    betaNew = updateBeta(X, Y, beta, phiNew, Lambda, lossType, tau, interecept);
-    double FVal = cmptF(X, Y, betaNew, lossType, tau);
-    double PsiVal = cmptPsi(X, Y, betaNew, beta, phiNew, lossType, tau, interecept);
-    if (FVal <= PsiVal) {
+  double phiNew = proxLAMM(X, arma::uvec(), arma::zeros(X.n_cols), arma::ones(X.n_cols), Y,
+                           Lambda, beta, betaNew, phi, lossType, tau, gamma, interecept);
+  return Rcpp::List::create(Rcpp::Named("beta") = betaNew, Rcpp::Named("phi") = phiNew);
+}
+
+// One epoch of proximal SVRG from the snapshot beta: the full gradient is computed once at beta,
+// then n / batchSize proximal steps are taken along variance-reduced mini-batch gradients. Each
+// step keeps the majorization check of LAMM on its mini-batch, inflating phi until it holds.
+// The result is written to betaNew and the inflated phi is returned. If a line search fails as in
+// proxLAMM, betaNew = beta and -1 is returned.
+double LAMMSVRG(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                const arma::vec& colScale, const arma::vec& Y, const arma::vec& Lambda,
+                const arma::vec& beta, arma::vec& betaNew, const double phi,
+                const std::string lossType, const double tau, const double gamma,
+                const bool intercept, const int batchSize, std::mt19937& rng) {
+  int n = Y.size();
+  arma::vec gradSnap = gradLoss(X, rows, colMean, colScale, Y, beta, lossType, tau, intercept);
+  std::uniform_int_distribution<int> unif(0, n - 1);
+  arma::uvec batch = arma::uvec(batchSize);
+  double phiNew = phi;
+  betaNew = beta;
+  int m = std::max(n / batchSize, 1);
+  for (int t = 0; t < m; t++) {
+    for (int i = 0; i < batchSize; i++) {
+      batch(i) = unif(rng);
+    }
+    // The mini-batch is an index view of X as well
+    arma::uvec rowsB = rows.is_empty() ? batch : arma::uvec(rows.elem(batch));
+    arma::vec YB = Y.rows(batch);
+    arma::vec gradB = gradLoss(X, rowsB, colMean, colScale, YB, betaNew, lossType, tau,
+                               intercept);
+    arma::vec direction = gradB - gradLoss(X, rowsB, colMean, colScale, YB, beta, lossType, tau,
+                                           intercept) + gradSnap;
+    double lossB = loss(YB, cmptXBeta(X, rowsB, colMean, colScale, betaNew), lossType, tau);
+    arma::vec betaTry = arma::vec();
+    bool accepted = false;
+    for (int k = 0; k <= backtrackMax; k++) {
+      betaTry = softThresh(betaNew - direction / phiNew, Lambda / phiNew);
+      arma::vec diff = betaTry - betaNew;
+      double FVal = loss(YB, cmptXBeta(X, rowsB, colMean, colScale, betaTry), lossType, tau);
+      double PsiVal = lossB + arma::dot(gradB, diff) + phiNew * arma::dot(diff, diff) / 2;
+      if (!std::isfinite(FVal) || !std::isfinite(PsiVal)) {
+        break;
+      }
+      if (FVal <= PsiVal) {
+        accepted = true;
+        break;
+      }
+      phiNew *= gamma;
+    }
+    if (!accepted) {
+      betaNew = beta;
+      return -1;
+    }
+    betaNew = betaTry;
+  }
+  return phiNew;
+}
+
+// One I-LAMM iteration with the chosen solver, "LAMM" or "SVRG", -1 if its line search failed
+double stepLAMM(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                const arma::vec& colScale, const arma::vec& Y, const arma::vec& Lambda,
+                const arma::vec& beta, arma::vec& betaNew, const double phi,
+                const std::string lossType, const double tau, const double gamma,
+                const bool intercept, const std::string solver, const int batchSize,
+                std::mt19937& rng) {
+  if (solver == "SVRG") {
+    return LAMMSVRG(X, rows, colMean, colScale, Y, Lambda, beta, betaNew, phi, lossType, tau,
+                    gamma, intercept, batchSize, rng);
+  }
+  return proxLAMM(X, rows, colMean, colScale, Y, Lambda, beta, betaNew, phi, lossType, tau, gamma,
+                  intercept);
+}
+
+static void chkIntFn(void* dummy) {
+  R_CheckUserInterrupt();
+}
+
+// Check for a user interrupt without long-jumping over the C++ stack
+bool checkInterrupt() {
+  return R_ToplevelExec(chkIntFn, NULL) == FALSE;
+}
+
+double elapsedTime(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Remaining time of a budget in seconds, -1 if there is no time budget
+double remainTime(const std::chrono::steady_clock::time_point& start, const double timeBudget) {
+  if (timeBudget <= 0) {
+    return -1;
+  }
+  return std::max(timeBudget - elapsedTime(start), 1e-9);
+}
+
+// The budget of a fit, shared by all its stages and its pilot fit. Only the main thread may check
+// for R user interrupts, fits on other threads are stopped through cancel, which may be NULL.
+struct Budget {
+  std::chrono::steady_clock::time_point start;
+  double timeBudget;
+  int iteBudget;
+  int iteTotal;
+  bool checkUser;
+  std::atomic<bool>* cancel;
+  // The last check for user interrupts, left at the epoch by aggregate initialization
+  std::chrono::steady_clock::time_point lastCheck;
+};
+
+// 2 if the iteration budget is exhausted, 3 if the time budget is exceeded, 4 if the user
+// interrupted or the fit was cancelled, and 0 otherwise. Non-positive budgets mean no limit. User
+// interrupts are checked at most every 0.1 seconds, since R_ToplevelExec isn't cheap next to a
+// LAMM step on small data.
+int checkBudget(Budget& budget) {
+  if (budget.iteBudget > 0 && budget.iteTotal >= budget.iteBudget) {
+    return 2;
+  }
+  if (budget.timeBudget > 0 && elapsedTime(budget.start) >= budget.timeBudget) {
+    return 3;
+  }
+  if (budget.cancel != NULL && budget.cancel->load()) {
+    return 4;
+  }
+  if (budget.checkUser) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - budget.lastCheck < std::chrono::milliseconds(100)) {
+      return 0;
+    }
+    budget.lastCheck = now;
+    if (checkInterrupt()) {
+      if (budget.cancel != NULL) {
+        budget.cancel->store(true);
+      }
+      return 4;
+    }
+  }
+  return 0;
+}
+
+// Semismooth Newton on the reweighted problem with penalty weights Lambda, with the support of
+// beta and the signs on it held fixed, started from beta and overwriting it. The generalized
+// Hessian X_S^T W X_S / n, where W is the indicator of |res| <= tau for the Huber loss, is only
+// |S| by |S|. Returns true if it converged and the KKT condition holds off the support, and false
+// as soon as the support would change, then LAMM takes over from beta. The steps are counted in
+// ite and the budget, and status is set if the budget stops the fit.
+bool newtonLAMM(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                const arma::vec& colScale, const arma::vec& Y, const arma::vec& Lambda,
+                arma::vec& beta, const std::string lossType, const double tau,
+                const double epsilon, const int iteMax, const bool intercept, Budget& budget,
+                int& ite, int& status) {
+  int n = Y.size();
+  int d = X.n_cols - 1;
+  arma::uvec inS = beta != 0;
+  inS(0) = intercept;
+  arma::uvec S = arma::find(inS);
+  if (S.is_empty()) {
+    return false;
+  }
+  arma::vec sgnS = arma::sign(beta.elem(S));
+  arma::vec LambdaS = Lambda.elem(S) % sgnS;
+  arma::rowvec meanS = colMean.elem(S).t();
+  arma::rowvec scaleS = colScale.elem(S).t();
+  arma::mat XS = rows.is_empty() ? arma::mat(X.cols(S)) : arma::mat(X.submat(rows, S));
+  XS.each_row() -= meanS;
+  XS.each_row() /= scaleS;
+  arma::vec betaS = beta.elem(S);
+  // The penalty is linear on the orthant of sgnS
+  double obj = loss(Y, XS * betaS, lossType, tau) + arma::dot(LambdaS, betaS);
+  while (ite <= iteMax) {
+    ite++;
+    budget.iteTotal++;
+    arma::vec res = Y - XS * betaS;
+    arma::vec w = arma::ones(n);
+    if (lossType == "Huber") {
+      w = arma::conv_to<arma::vec>::from(arma::abs(res) <= tau);
+      res = arma::clamp(res, -tau, tau);
+    }
+    arma::vec grad = LambdaS - XS.t() * res / n;
+    arma::mat H = XS.t() * (XS.each_col() % w) / n;
+    H.diag() += 1e-10 * arma::max(H.diag());
+    arma::mat R;
+    if (!arma::chol(R, H)) {
+      return false;
+    }
+    arma::vec step = arma::solve(arma::trimatu(R), arma::solve(arma::trimatl(R.t()), grad));
+    double t = 1;
+    arma::vec betaTry = betaS - step;
+    double objTry = loss(Y, XS * betaTry, lossType, tau) + arma::dot(LambdaS, betaTry);
+    while (objTry > obj && t > 1e-8) {
+      t /= 2;
+      betaTry = betaS - t * step;
+      objTry = loss(Y, XS * betaTry, lossType, tau) + arma::dot(LambdaS, betaTry);
+    }
+    if (objTry > obj) {
+      return false;
+    }
+    // A coefficient that crosses zero leaves the support
+    for (int k = 0; k < (int)S.size(); k++) {
+      if (S(k) > 0 && betaTry(k) * sgnS(k) <= 0) {
+        return false;
+      }
+    }
+    double diff = arma::norm(betaTry - betaS, 2) / std::sqrt(d + 1);
+    betaS = betaTry;
+    obj = objTry;
+    beta.elem(S) = betaS;
+    if (diff <= epsilon) {
+      arma::vec gradFull = gradLoss(X, rows, colMean, colScale, Y, beta, lossType, tau, intercept);
+      for (int j = 1; j <= d; j++) {
+        if (!inS(j) && std::abs(gradFull(j)) > Lambda(j)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    int check = checkBudget(budget);
+    if (check > 0) {
+      status = check;
+      return false;
+    }
+  }
+  return false;
+}
+
+// The I-LAMM iterations, contraction and then tightening, on the design X (with the intercept
+// column) restricted to rows, see cmptXBeta, where Y is the response of those rows. beta is the
+// initial value on the standardized scale and it's overwritten by the solution, phi and iteT get
+// the final phi and the number of tightenings. If warm is set, a nonzero beta is a nearby solution
+// and it's taken as the result of the contraction for SCAD and MCP, since the contraction would
+// pull it back to the Lasso solution first. The R API is only touched if budget.checkUser is
+// set, so the fit can run on worker threads. Returns the status, see ncvxReg.
+int ilamm(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+          const arma::vec& colScale, const arma::vec& Y, arma::vec& beta, const double lambda,
+          const std::string penalty, const std::string lossType, const double tau,
+          const double phi0, const double gamma, const double epsilon_c, const double epsilon_t,
+          const int iteMax, const bool intercept, const std::string solver, const int batchSize,
+          const bool warm, std::mt19937& rng, Budget& budget, double& phi, int& iteT) {
+  int n = Y.size();
+  int d = X.n_cols - 1;
+  int batch = batchSize > 0 ? std::min(batchSize, n) : (int)std::ceil(std::sqrt((double)n));
+  int status = 0;
+  arma::vec betaNew = beta;
+  // Contraction
+  arma::vec Lambda = cmptLambda(arma::zeros(d + 1), lambda, penalty);
+  phi = phi0;
+  int ite = 0;
+  bool contract = !warm || penalty == "Lasso" || !arma::any(beta.tail(d));
+  while (contract && ite <= iteMax && status == 0) {
+    ite++;
+    budget.iteTotal++;
+    phi = stepLAMM(X, rows, colMean, colScale, Y, Lambda, beta, betaNew, phi, lossType, tau,
+                   gamma, intercept, solver, batch, rng);
+    if (phi < 0) {
+      status = 5;
       break;
     }
-    phiNew *= gamma;
+    phi = std::max(phi0, phi / gamma);
+    if (arma::norm(betaNew - beta, 2) / std::sqrt(d + 1) <= epsilon_c) {
+      break;
+    }
+    beta = betaNew;
+    status = checkBudget(budget);
   }
-  return Rcpp::List::create(Rcpp::Named("beta") = betaNew, Rcpp::Named("phi") = phiNew);
+  if (ite > iteMax) {
+    status = std::max(status, 1);
+  }
+  iteT = 0;
+  // Tightening
+  if (penalty != "Lasso" && status <= 1) {
+    arma::vec beta0 = arma::zeros(d + 1);
+    while (iteT <= iteMax) {
+      iteT++;
+      beta = betaNew;
+      beta0 = betaNew;
+      Lambda = cmptLambda(beta, lambda, penalty);
+      phi = phi0;
+      ite = 0;
+      bool solved = false;
+      if (solver == "Newton") {
+        solved = newtonLAMM(X, rows, colMean, colScale, Y, Lambda, betaNew, lossType, tau,
+                            epsilon_t, iteMax, intercept, budget, ite, status);
+        beta = betaNew;
+      }
+      while (!solved && status <= 1 && ite <= iteMax) {
+        ite++;
+        budget.iteTotal++;
+        phi = stepLAMM(X, rows, colMean, colScale, Y, Lambda, beta, betaNew, phi, lossType, tau,
+                       gamma, intercept, solver, batch, rng);
+        if (phi < 0) {
+          status = 5;
+          break;
+        }
+        phi = std::max(phi0, phi / gamma);
+        if (arma::norm(betaNew - beta, 2) / std::sqrt(d + 1) <= epsilon_t) {
+          break;
+        }
+        beta = betaNew;
+        int check = checkBudget(budget);
+        if (check > 0) {
+          status = check;
+          break;
+        }
+      }
+      if (ite > iteMax) {
+        status = std::max(status, 1);
+      }
+      if (status > 1 || arma::norm(betaNew - beta0, 2) / std::sqrt(d + 1) <= epsilon_t) {
+        break;
+      }
+    }
+    if (iteT > iteMax) {
+      status = std::max(status, 1);
+    }
+  }
+  beta = betaNew;
+  return status;
+}
+
+// The default lambda, see ncvxReg, on the rows of X, see cmptXBeta
+double defaultLambda(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+                     const arma::vec& colScale, const arma::vec& Y) {
+  int n = Y.size();
+  arma::vec XtY = cmptXtRes(X, rows, colMean, colScale, Y);
+  double lambdaMax = arma::max(arma::abs(XtY)) / n;
+  double lambdaMin = 0.01 * lambdaMax;
+  return std::exp((long double)(0.7 * std::log((long double)lambdaMax)
+                                + 0.3 * std::log((long double)lambdaMin)));
+}
+
+// The default tau from the residuals of the Lasso pilot fit at lambda, see ncvxHuberReg. The pilot
+// fit shares the budget of the Huber fit, but it may only use half of the iterations left, so the
+// Huber fit is never starved by it. Returns the status of the pilot fit, where 2 means it used up
+// its half.
+int defaultTau(const arma::mat& X, const arma::vec& colMean, const arma::vec& colScale,
+               const arma::vec& Y, const double lambda, const double phi0, const double gamma,
+               const double epsilon_c, const double epsilon_t, const int iteMax,
+               const bool intercept, const std::string solver, const int batchSize,
+               std::mt19937& rng, Budget& budget, double& tau) {
+  int n = Y.size();
+  int d = X.n_cols - 1;
+  arma::vec betaLasso = arma::zeros(d + 1);
+  double phi = phi0;
+  int iteT = 0;
+  Budget pilotBudget = budget;
+  if (budget.iteBudget > 0) {
+    pilotBudget.iteBudget = budget.iteTotal + std::max((budget.iteBudget - budget.iteTotal) / 2, 1);
+  }
+  int status = ilamm(X, arma::uvec(), colMean, colScale, Y, betaLasso, lambda, "Lasso", "l2", 1,
+                     phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, solver, batchSize,
+                     false, rng, pilotBudget, phi, iteT);
+  budget.iteTotal = pilotBudget.iteTotal;
+  arma::vec res = Y - cmptXBeta(X, arma::uvec(), colMean, colScale, betaLasso);
+  double sigmaHat = arma::median(arma::abs(res - arma::median(res))) / 0.6745;
+  tau = sigmaHat * std::sqrt((long double)(n / std::log((double)n * d)));
+  return status;
+}
+
+// Stop on missing or infinite values of X or Y, the line search of LAMM can't recover from them
+void checkData(const arma::mat& X, const arma::vec& Y) {
+  if (!X.is_finite() || !Y.is_finite()) {
+    Rcpp::stop("X and Y must not have missing or infinite values");
+  }
+}
+
+// Stop on an unknown solver or a batch size that is neither positive nor the default -1
+void checkSolver(const std::string solver, const int batchSize) {
+  if (solver != "LAMM" && solver != "SVRG" && solver != "Newton") {
+    Rcpp::stop("solver must be \"LAMM\", \"SVRG\" or \"Newton\"");
+  }
+  if (batchSize <= 0 && batchSize != -1) {
+    Rcpp::stop("batchSize must be positive, or -1 for the default");
+  }
+}
+
+// The fit of ncvxReg (lossType "l2") and ncvxHuberReg ("Huber") on X with the intercept column.
+// The R API is only touched if budget.checkUser is set, so background jobs run it as well. lambda,
+// and tau for "Huber", are set to their defaults if they're not positive. beta is the initial
+// value on the original scale if warm, and the fit on the original scale on exit. Returns the
+// status, see ncvxReg.
+int fitCore(const arma::mat& X, const arma::vec& Y, double& lambda, double& tau,
+            const std::string penalty, const std::string lossType, const double phi0,
+            const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax,
+            const bool intercept, const bool standardize, const std::string solver,
+            const int batchSize, const bool warm, std::mt19937& rng, Budget& budget,
+            arma::vec& beta, double& phi, int& iteT) {
+  int d = X.n_cols - 1;
+  arma::vec colMean = arma::zeros(d + 1);
+  arma::vec colScale = arma::ones(d + 1);
+  if (standardize) {
+    cmptColScale(X, arma::uvec(), colMean, colScale, intercept);
+  }
+  if (lambda <= 0) {
+    lambda = defaultLambda(X, arma::uvec(), colMean, colScale, Y);
+  }
+  int status = 0;
+  if (lossType == "Huber" && tau <= 0) {
+    status = defaultTau(X, colMean, colScale, Y, lambda, phi0, gamma, epsilon_c, epsilon_t,
+                        iteMax, intercept, solver, batchSize, rng, budget, tau);
+  }
+  beta = warm ? scaleBeta(beta, colMean, colScale) : arma::vec(arma::zeros(d + 1));
+  phi = phi0;
+  iteT = 0;
+  if (status <= 2) {
+    status = ilamm(X, arma::uvec(), colMean, colScale, Y, beta, lambda, penalty, lossType, tau,
+                   phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, solver, batchSize, warm,
+                   rng, budget, phi, iteT);
+  }
+  beta = unscaleBeta(beta, colMean, colScale);
+  return status;
 }
 
 //' The function fits (high-dimensional) regularized regression with non-convex penalties: Lasso, SCAD and MCP, and it's implemented via I-LAMM algorithm.
@@ -144,6 +770,12 @@ Rcpp::List LAMM(const arma::mat& X, const arma::vec& Y, const arma::vec& Lambda,
 //' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
 //' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
 //' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting. The columns are centered (if \code{intercept = TRUE}) and scaled implicitly inside the I-LAMM iterations without copying \eqn{X}, so \eqn{\lambda} is applied on the standardized scale, and the returned \code{beta} is on the original scale. It usually reduces the number of iterations a lot when the columns of \eqn{X} have very different scales. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the fit in seconds. The iterations stop at the first check after it's exceeded, and the last iterate is returned with \code{status = 3}. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations over all stages of the fit, while \code{iteMax} applies to each stage separately, so the nested tightening loops can take up to \code{iteMax}^2 iterations. Non-positive values mean no limit. The default value is -1.
+//' @param betaInit Optional initial value of \eqn{\beta} on the original scale to warm start the I-LAMM iterations, a vector with length d + 1 with the first one being the intercept, e.g. the solution at a nearby \eqn{\lambda}. For SCAD and MCP, a nonzero initial value is taken as the result of the contraction stage, which would pull it back to the Lasso solution, so the iterations go straight to tightening. The iterations start from zero if it's not specified.
+//' @param solver The solver of each I-LAMM iteration, possible choices are "LAMM" (default), "SVRG" and "Newton". "LAMM" takes one proximal gradient step with the full gradient, and "SVRG" runs an epoch of proximal stochastic variance reduced gradient steps on random mini-batches, anchored at one full gradient. Each "SVRG" step keeps the majorization check of LAMM on its mini-batch. "SVRG" needs much fewer passes over the data when \eqn{n} is very large, and its random mini-batches are seeded from R's random number generator, so \code{set.seed} makes it reproducible. "Newton" takes LAMM steps in the contraction stage, then solves each reweighted problem of the tightening stage by semismooth Newton on the support of the current \eqn{\beta} (with the weights of the Huber loss), where each step only solves a linear system of the size of the support, and it falls back to LAMM steps as soon as the support changes. The tightening stage usually converges in a few Newton steps instead of hundreds of LAMM steps.
+//' @param batchSize The mini-batch size of the "SVRG" solver, each epoch takes \eqn{n} / \code{batchSize} steps. It must be positive, and the default value -1 means \eqn{\sqrt n} rounded up.
 //' @return A list including the following terms will be returned:
 //' \itemize{
 //' \item \code{beta} The estimated \eqn{\beta}, a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}).
@@ -151,6 +783,8 @@ Rcpp::List LAMM(const arma::mat& X, const arma::vec& Y, const arma::vec& Lambda,
 //' \item \code{penalty} The type of penalty.
 //' \item \code{lambda} The value of \eqn{\lambda}.
 //' \item \code{IteTightening} The number of tightenings in I-LAMM algorithm, and it's 0 if \code{penalty = "Lasso"}.
+//' \item \code{iteTotal} The total number of LAMM iterations over all stages.
+//' \item \code{status} The status of the fit: 0 if it converged, 1 if \code{iteMax} was reached in some stage, 2 if it was stopped by \code{iteBudget}, 3 if it was stopped by \code{timeBudget}, 4 if it was interrupted by the user and 5 if the step size search of LAMM failed, on non-finite values or after 1000 inflations of \code{phi}. In the last four cases, \code{beta} is the last iterate.
 //' }
 //' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
 //' @references Fan, J., Liu, H., Sun, Q. and Zhang, T. (2018). I-LAMM for sparse learning: Simultaneous control of algorithmic complexity and statistical error. Ann. Statist. 46 814–841.
@@ -174,67 +808,39 @@ Rcpp::List ncvxReg(arma::mat X, const arma::vec& Y, double lambda = -1,
                    std::string penalty = "SCAD", const double phi0 = 0.001,
                    const double gamma = 1.5, const double epsilon_c = 0.0001,
                    const double epsilon_t = 0.0001, const int iteMax = 500,
-                   const bool intercept = false, const bool itcpIncluded = false) {
+                   const bool intercept = false, const bool itcpIncluded = false,
+                   const bool standardize = false, const double timeBudget = -1,
+                   const int iteBudget = -1,
+                   Rcpp::Nullable<Rcpp::NumericVector> betaInit = R_NilValue,
+                   const std::string solver = "LAMM", const int batchSize = -1) {
+  checkData(X, Y);
+  checkSolver(solver, batchSize);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
   if (!itcpIncluded) {
     arma::mat XX = arma::ones(X.n_rows, X.n_cols + 1);
     XX.cols(1, X.n_cols) = X;
     X = XX;
   }
-  int n = Y.size();
-  int d = X.n_cols - 1;
-  if (lambda <= 0) {
-    double lambdaMax = arma::max(arma::abs(Y.t() * X)) / n;
-    double lambdaMin = 0.01 * lambdaMax;
-    lambda = std::exp((long double)(0.7 * std::log((long double)lambdaMax)
-                                      + 0.3 * std::log((long double)lambdaMin)));
+  arma::vec beta = arma::vec();
+  if (betaInit.isNotNull()) {
+    beta = Rcpp::as<arma::vec>(betaInit);
   }
-  arma::vec beta = arma::zeros(d + 1);
-  arma::vec betaNew = arma::zeros(d + 1);
-  // Contraction
-  arma::vec Lambda = cmptLambda(beta, lambda, penalty);
-  double phi = phi0;
-  int ite = 0;
-  while (ite <= iteMax) {
-    ite++;
-    Rcpp::List listLAMM = LAMM(X, Y, Lambda, beta, phi, "l2", 1, gamma, intercept);
-    betaNew = Rcpp::as<arma::vec>(listLAMM["beta"]);
-    phi = listLAMM["phi"];
-    phi = std::max(phi0, phi / gamma);
-    if (arma::norm(betaNew - beta, 2) / std::sqrt(d + 1) <= epsilon_c) {
-      break;
-    }
-    beta = betaNew;
+  std::mt19937 rng;
+  if (solver == "SVRG") {
+    rng.seed((unsigned int)(R::unif_rand() * 4294967295.0));
   }
+  Budget budget = {start, timeBudget, iteBudget, 0, true, NULL};
+  double tau = 1;
+  double phi = phi0;
   int iteT = 0;
-  // Tightening
-  if (penalty != "Lasso") {
-    arma::vec beta0 = arma::zeros(d + 1);
-    while (iteT <= iteMax) {
-      iteT++;
-      beta = betaNew;
-      beta0 = betaNew;
-      Lambda = cmptLambda(beta, lambda, penalty);
-      phi = phi0;
-      ite = 0;
-      while (ite <= iteMax) {
-        ite++;
-        Rcpp::List listLAMM  = LAMM(X, Y, Lambda, beta, phi, "l2", 1, gamma, intercept);
-        betaNew = Rcpp::as<arma::vec>(listLAMM["beta"]);
-        phi = listLAMM["phi"];
-        phi = std::max(phi0, phi / gamma);
-        if (arma::norm(betaNew - beta, 2) / std::sqrt(d + 1) <= epsilon_t) {
-          break;
-        }
-        beta = betaNew;
-      }
-      if (arma::norm(betaNew - beta0, 2) / std::sqrt(d + 1) <= epsilon_t) {
-        break;
-      }
-    }
-  }
-  return Rcpp::List::create(Rcpp::Named("beta") = betaNew, Rcpp::Named("phi") = phi,
+  int status = fitCore(X, Y, lambda, tau, penalty, "l2", phi0, gamma, epsilon_c, epsilon_t,
+                       iteMax, intercept, standardize, solver, batchSize, betaInit.isNotNull(),
+                       rng, budget, beta, phi, iteT);
+  return Rcpp::List::create(Rcpp::Named("beta") = beta, Rcpp::Named("phi") = phi,
                             Rcpp::Named("penalty") = penalty, Rcpp::Named("lambda") = lambda,
-                            Rcpp::Named("IteTightening") = iteT);
+                            Rcpp::Named("IteTightening") = iteT,
+                            Rcpp::Named("iteTotal") = budget.iteTotal,
+                            Rcpp::Named("status") = status);
 }
 
 //' The function fits (high-dimensional) Huber regularized regression with non-convex penalties: Lasso, SCAD and MCP, and it's implemented via I-LAMM algorithm.
@@ -254,6 +860,12 @@ Rcpp::List ncvxReg(arma::mat X, const arma::vec& Y, double lambda = -1,
 //' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
 //' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
 //' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting. The columns are centered (if \code{intercept = TRUE}) and scaled implicitly inside the I-LAMM iterations without copying \eqn{X}, so \eqn{\lambda} is applied on the standardized scale, and the returned \code{beta} is on the original scale. It usually reduces the number of iterations a lot when the columns of \eqn{X} have very different scales. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the fit in seconds. The iterations stop at the first check after it's exceeded, and the last iterate is returned with \code{status = 3}. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations over all stages of the fit, while \code{iteMax} applies to each stage separately, so the nested tightening loops can take up to \code{iteMax}^2 iterations. If \code{tau} is not specified, the Lasso pilot fit may use at most half of it. Non-positive values mean no limit. The default value is -1.
+//' @param betaInit Optional initial value of \eqn{\beta} on the original scale to warm start the I-LAMM iterations, a vector with length d + 1 with the first one being the intercept, e.g. the solution at a nearby \eqn{\lambda}. For SCAD and MCP, a nonzero initial value is taken as the result of the contraction stage, which would pull it back to the Lasso solution, so the iterations go straight to tightening. The iterations start from zero if it's not specified.
+//' @param solver The solver of each I-LAMM iteration, possible choices are "LAMM" (default), "SVRG" and "Newton". "LAMM" takes one proximal gradient step with the full gradient, and "SVRG" runs an epoch of proximal stochastic variance reduced gradient steps on random mini-batches, anchored at one full gradient. Each "SVRG" step keeps the majorization check of LAMM on its mini-batch. "SVRG" needs much fewer passes over the data when \eqn{n} is very large, and its random mini-batches are seeded from R's random number generator, so \code{set.seed} makes it reproducible. "Newton" takes LAMM steps in the contraction stage, then solves each reweighted problem of the tightening stage by semismooth Newton on the support of the current \eqn{\beta} (with the weights of the Huber loss), where each step only solves a linear system of the size of the support, and it falls back to LAMM steps as soon as the support changes. The tightening stage usually converges in a few Newton steps instead of hundreds of LAMM steps.
+//' @param batchSize The mini-batch size of the "SVRG" solver, each epoch takes \eqn{n} / \code{batchSize} steps. It must be positive, and the default value -1 means \eqn{\sqrt n} rounded up.
 //' @return A list including the following terms will be returned:
 //' \itemize{
 //' \item \code{beta} The estimated \eqn{\beta}, a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}).
@@ -262,6 +874,8 @@ Rcpp::List ncvxReg(arma::mat X, const arma::vec& Y, double lambda = -1,
 //' \item \code{lambda} The value of \eqn{\lambda}.
 //' \item \code{tau} The value of \eqn{\tau}.
 //' \item \code{IteTightening} The number of tightenings in I-LAMM algorithm, and it's 0 if \code{penalty = "Lasso"}.
+//' \item \code{iteTotal} The total number of LAMM iterations over all stages.
+//' \item \code{status} The status of the fit: 0 if it converged, 1 if \code{iteMax} was reached in some stage, 2 if it was stopped by \code{iteBudget}, 3 if it was stopped by \code{timeBudget}, 4 if it was interrupted by the user and 5 if the step size search of LAMM failed, on non-finite values or after 1000 inflations of \code{phi}. In the last four cases, \code{beta} is the last iterate.
 //' }
 //' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
 //' @references Fan, J., Liu, H., Sun, Q. and Zhang, T. (2018). I-LAMM for sparse learning: Simultaneous control of algorithmic complexity and statistical error. Ann. Statist. 46 814–841.
@@ -285,76 +899,38 @@ Rcpp::List ncvxHuberReg(arma::mat X, const arma::vec& Y, double lambda = -1,
                 std::string penalty = "SCAD", double tau = -1, const double phi0 = 0.001,
                 const double gamma = 1.5, const double epsilon_c = 0.0001,
                 const double epsilon_t = 0.0001, const int iteMax = 500,
-                const bool intercept = false, const bool itcpIncluded = false) {
+                const bool intercept = false, const bool itcpIncluded = false,
+                const bool standardize = false, const double timeBudget = -1,
+                const int iteBudget = -1,
+                Rcpp::Nullable<Rcpp::NumericVector> betaInit = R_NilValue,
+                const std::string solver = "LAMM", const int batchSize = -1) {
+  checkData(X, Y);
+  checkSolver(solver, batchSize);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
   if (!itcpIncluded) {
     arma::mat XX = arma::ones(X.n_rows, X.n_cols + 1);
     XX.cols(1, X.n_cols) = X;
     X = XX;
   }
-  int n = Y.size();
-  int d = X.n_cols - 1;
-  if (lambda <= 0) {
-    double lambdaMax = arma::max(arma::abs(Y.t() * X)) / n;
-    double lambdaMin = 0.01 * lambdaMax;
-    lambda = std::exp((long double)(0.7 * std::log((long double)lambdaMax)
-                      + 0.3 * std::log((long double)lambdaMin)));
+  arma::vec beta = arma::vec();
+  if (betaInit.isNotNull()) {
+    beta = Rcpp::as<arma::vec>(betaInit);
   }
-  if (tau <= 0) {
-    Rcpp::List listILAMM = ncvxReg(X, Y, lambda, "Lasso", phi0, gamma, epsilon_c, epsilon_t,
-                                   iteMax, intercept, true);
-    arma::vec betaLasso = Rcpp::as<arma::vec>(listILAMM["beta"]);
-    arma::vec Yhat = X * betaLasso;
-    arma::vec res = Y - Yhat;
-    double sigmaHat = arma::median(arma::abs(res - arma::median(res))) / 0.6745;
-    tau = sigmaHat * std::sqrt((long double)(n / std::log(n * d)));
+  std::mt19937 rng;
+  if (solver == "SVRG") {
+    rng.seed((unsigned int)(R::unif_rand() * 4294967295.0));
   }
-  arma::vec beta = arma::zeros(d + 1);
-  arma::vec betaNew = arma::zeros(d + 1);
-  // Contraction
-  arma::vec Lambda = cmptLambda(beta, lambda, penalty);
+  Budget budget = {start, timeBudget, iteBudget, 0, true, NULL};
   double phi = phi0;
-  int ite = 0;
-  while (ite <= iteMax) {
-    ite++;
-    Rcpp::List listLAMM = LAMM(X, Y, Lambda, beta, phi, "Huber", tau, gamma, intercept);
-    betaNew = Rcpp::as<arma::vec>(listLAMM["beta"]);
-    phi = listLAMM["phi"];
-    phi = std::max(phi0, phi / gamma);
-    if (arma::norm(betaNew - beta, 2) / std::sqrt(d + 1) <= epsilon_c) {
-      break;
-    }
-    beta = betaNew;
-  }
   int iteT = 0;
-  // Tightening
-  if (penalty != "Lasso") {
-    arma::vec beta0 = arma::zeros(d + 1);
-    while (iteT <= iteMax) {
-      iteT++;
-      beta = betaNew;
-      beta0 = betaNew;
-      Lambda = cmptLambda(beta, lambda, penalty);
-      phi = phi0;
-      ite = 0;
-      while (ite <= iteMax) {
-        ite++;
-        Rcpp::List listLAMM  = LAMM(X, Y, Lambda, beta, phi, "Huber", tau, gamma, intercept);
-        betaNew = Rcpp::as<arma::vec>(listLAMM["beta"]);
-        phi = listLAMM["phi"];
-        phi = std::max(phi0, phi / gamma);
-        if (arma::norm(betaNew - beta, 2) / std::sqrt(d + 1) <= epsilon_t) {
-          break;
-        }
-        beta = betaNew;
-      }
-      if (arma::norm(betaNew - beta0, 2) / std::sqrt(d + 1) <= epsilon_t) {
-        break;
-      }
-    }
-  }
-  return Rcpp::List::create(Rcpp::Named("beta") = betaNew, Rcpp::Named("phi") = phi,
+  int status = fitCore(X, Y, lambda, tau, penalty, "Huber", phi0, gamma, epsilon_c, epsilon_t,
+                       iteMax, intercept, standardize, solver, batchSize, betaInit.isNotNull(),
+                       rng, budget, beta, phi, iteT);
+  return Rcpp::List::create(Rcpp::Named("beta") = beta, Rcpp::Named("phi") = phi,
                             Rcpp::Named("penalty") = penalty, Rcpp::Named("lambda") = lambda,
-                            Rcpp::Named("tau") = tau, Rcpp::Named("IteTightening") = iteT);
+                            Rcpp::Named("tau") = tau, Rcpp::Named("IteTightening") = iteT,
+                            Rcpp::Named("iteTotal") = budget.iteTotal,
+                            Rcpp::Named("status") = status);
 }
 
 // [[Rcpp::export]]
@@ -384,10 +960,452 @@ arma::vec tauConst(int n) {
   return rst;
 }
 
+// Cached result of the fit on one fold (fold = -1 for the full data, -2 for the final fit) at one
+// grid cell, tau = 0 for the least squares loss and for the Lasso pilot of the Huber loss
+struct CacheEntry {
+  double lambda;
+  double tau;
+  int fold;
+  arma::vec beta;
+};
+
+// 64-bit FNV-1a hash of a byte range, chained through h
+uint64_t hashBytes(const void* data, const size_t size, uint64_t h = 14695981039346656037ULL) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  for (size_t i = 0; i < size; i++) {
+    h ^= bytes[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// Path of the cache file of a cross validation, keyed by the content of X and Y, the fold
+// assignment and the solver settings, but not by the grid of lambda's and tau's
+std::string cachePath(const std::string& cacheDir, const arma::mat& X, const arma::vec& Y,
+                      const int nfolds, const std::string lossType, const std::string penalty,
+                      const double phi0, const double gamma, const double epsilon_c,
+                      const double epsilon_t, const int iteMax, const bool intercept,
+                      const bool standardize) {
+  uint64_t h = hashBytes(X.memptr(), X.n_elem * sizeof(double));
+  h = hashBytes(Y.memptr(), Y.n_elem * sizeof(double), h);
+  arma::uword dims[2] = {X.n_rows, X.n_cols};
+  h = hashBytes(dims, sizeof(dims), h);
+  int settingsInt[4] = {nfolds, iteMax, intercept, standardize};
+  h = hashBytes(settingsInt, sizeof(settingsInt), h);
+  double settingsDouble[4] = {phi0, gamma, epsilon_c, epsilon_t};
+  h = hashBytes(settingsDouble, sizeof(settingsDouble), h);
+  std::string types = lossType + "/" + penalty;
+  h = hashBytes(types.data(), types.size(), h);
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx", (unsigned long long)h);
+  return cacheDir + "/" + key + ".ilamm";
+}
+
+// A cache file starts with a header of a magic number, the version of the format and the length of
+// the coefficients, followed by the records
+const uint32_t cacheMagic = 0x494c4d43;
+const int cacheVersion = 1;
+
+// Read the records of a cache file, whose coefficients must have length len. clean is set if the
+// file ends right after a complete record. A file with a header that doesn't match, or a record of
+// another length (a corrupt file or a hash collision) or cut by an interrupted write, stops the
+// reading and leaves clean unset.
+std::vector<CacheEntry> readCache(const std::string& path, const int len, bool& clean) {
+  std::vector<CacheEntry> cache;
+  clean = false;
+  std::ifstream in(path.c_str(), std::ios::binary);
+  uint32_t magic = 0;
+  int header[2] = {0, 0};
+  in.read((char*)&magic, sizeof(uint32_t));
+  in.read((char*)header, sizeof(header));
+  if (!in || magic != cacheMagic || header[0] != cacheVersion || header[1] != len) {
+    return cache;
+  }
+  while (true) {
+    if (in.peek() == std::char_traits<char>::eof()) {
+      clean = true;
+      break;
+    }
+    CacheEntry entry;
+    int lenEntry = 0;
+    in.read((char*)&entry.lambda, sizeof(double));
+    in.read((char*)&entry.tau, sizeof(double));
+    in.read((char*)&entry.fold, sizeof(int));
+    in.read((char*)&lenEntry, sizeof(int));
+    if (!in || lenEntry != len) {
+      break;
+    }
+    entry.beta = arma::vec(len);
+    in.read((char*)entry.beta.memptr(), len * sizeof(double));
+    if (!in) {
+      break;
+    }
+    cache.push_back(entry);
+  }
+  return cache;
+}
+
+void writeCacheEntry(std::ofstream& out, const CacheEntry& entry) {
+  int len = entry.beta.size();
+  out.write((const char*)&entry.lambda, sizeof(double));
+  out.write((const char*)&entry.tau, sizeof(double));
+  out.write((const char*)&entry.fold, sizeof(int));
+  out.write((const char*)&len, sizeof(int));
+  out.write((const char*)entry.beta.memptr(), len * sizeof(double));
+}
+
+// Open the cache file before the grid search and return its records. If the file is missing or
+// isn't clean, it's rewritten with a new header and the valid records, so later appends stay
+// aligned. Stops at once if the file can't be written, e.g. if the directory doesn't exist.
+std::vector<CacheEntry> openCache(const std::string& path, const int len) {
+  bool clean = false;
+  std::vector<CacheEntry> cache = readCache(path, len, clean);
+  std::ofstream out;
+  if (clean) {
+    out.open(path.c_str(), std::ios::binary | std::ios::app);
+  } else {
+    out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    int header[2] = {cacheVersion, len};
+    out.write((const char*)&cacheMagic, sizeof(uint32_t));
+    out.write((const char*)header, sizeof(header));
+    for (int i = 0; i < (int)cache.size(); i++) {
+      writeCacheEntry(out, cache[i]);
+    }
+  }
+  if (!out) {
+    Rcpp::stop("Can't write to the cache file " + path);
+  }
+  return cache;
+}
+
+// It throws a standard exception rather than calling Rcpp::stop, as it's called from cvCore
+void appendCache(const std::string& path, const CacheEntry& entry) {
+  std::ofstream out(path.c_str(), std::ios::binary | std::ios::app);
+  writeCacheEntry(out, entry);
+  if (!out) {
+    throw std::runtime_error("Can't write to the cache file " + path);
+  }
+}
+
+// Distance on log scale between a cached entry and (lambda, tau), tau is ignored if it's 0
+double cacheDist(const CacheEntry& entry, const double lambda, const double tau) {
+  double rst = std::abs(std::log(entry.lambda / lambda));
+  if (tau > 0) {
+    rst += std::abs(std::log(entry.tau / tau));
+  }
+  return rst;
+}
+
+// Index of the cached entry of a fold at (lambda, tau), or of the nearest one on log scale if
+// exact is false, and -1 if there is none
+int findCache(const std::vector<CacheEntry>& cache, const double lambda, const double tau,
+              const int fold, const bool exact) {
+  int rst = -1;
+  double minDist = arma::datum::inf;
+  for (int i = 0; i < (int)cache.size(); i++) {
+    if (cache[i].fold != fold) {
+      continue;
+    }
+    if (cache[i].lambda == lambda && cache[i].tau == tau) {
+      return i;
+    }
+    double dist = cacheDist(cache[i], lambda, tau);
+    if (!exact && dist < minDist) {
+      minDist = dist;
+      rst = i;
+    }
+  }
+  return rst;
+}
+
+// Warm start for a fit from the cached fit of the same fold at the nearest grid value, empty if
+// there is none closer than maxDist, see cacheDist
+arma::vec cacheWarmStart(const std::vector<CacheEntry>& cache, const double lambda,
+                         const double tau, const int fold, const double maxDist) {
+  int near = findCache(cache, lambda, tau, fold, false);
+  if (near < 0 || cacheDist(cache[near], lambda, tau) >= maxDist) {
+    return arma::vec();
+  }
+  return cache[near].beta;
+}
+
+// Norm of the approximate leave-one-out residuals of the fit beta (on the original scale) on the
+// design X with the intercept column. The fit is taken as the solution of the reweighted problem
+// restricted to its support S, whose penalty is linear there, so one Newton step without the i-th
+// sample gives y_i - x_i^T beta_(-i) = r_i + h_i psi(r_i) / (1 - w_i h_i), with w_i = psi'(r_i)
+// and h_i = x_i^T (X_S^T W X_S)^(-1) x_i. It's Inf if the restricted problem is degenerate.
+double cmptALO(const arma::mat& X, const arma::vec& Y, const arma::vec& beta,
+               const std::string lossType, const double tau, const bool intercept) {
+  int n = Y.size();
+  arma::vec res = Y - X * beta;
+  arma::uvec inS = beta != 0;
+  inS(0) = intercept;
+  arma::uvec S = arma::find(inS);
+  if (S.is_empty()) {
+    return arma::norm(res, 2);
+  }
+  arma::vec w = arma::ones(n);
+  arma::vec psi = res;
+  if (lossType == "Huber") {
+    w = arma::conv_to<arma::vec>::from(arma::abs(res) <= tau);
+    psi = arma::clamp(res, -tau, tau);
+  }
+  arma::mat XS = X.cols(S);
+  arma::mat R;
+  if (!arma::chol(R, XS.t() * (XS.each_col() % w))) {
+    return arma::datum::inf;
+  }
+  arma::mat Z = arma::solve(arma::trimatl(R.t()), XS.t());
+  arma::vec h = arma::sum(arma::square(Z), 0).t();
+  arma::vec denom = 1 - w % h;
+  if (denom.min() <= 1e-10) {
+    return arma::datum::inf;
+  }
+  return arma::norm(res + h % psi / denom, 2);
+}
+
+// Warm start of the fit on a fold (the last one is the full data) at the i-th lambda in the
+// homotopy of cvCore: the solution at the same lambda and the previous tau if fromTau, else the one
+// at the previous lambda lambdaPrev and the same tau. It's empty at the first cell, which starts
+// from zero.
+arma::vec homotopyStart(const arma::field<arma::vec>& betaCur,
+                        const arma::field<arma::vec>& betaPrev, const int i,
+                        const int lambdaPrev, const bool fromTau, const int fold) {
+  if (fromTau) {
+    return betaPrev(i, fold);
+  }
+  if (lambdaPrev >= 0) {
+    return betaCur(lambdaPrev, fold);
+  }
+  return arma::vec();
+}
+
+// One fit of a cross validation on the rows of X, see cmptXBeta, where Y is the response of those
+// rows. It's started from beta, which is overwritten by the solution, both on the original scale,
+// and warm is passed to ilamm.
+int cvFit(const arma::mat& X, const arma::uvec& rows, const arma::vec& colMean,
+          const arma::vec& colScale, const arma::vec& Y, arma::vec& beta, const double lambda,
+          const std::string penalty, const std::string lossType, const double tau,
+          const double phi0, const double gamma, const double epsilon_c, const double epsilon_t,
+          const int iteMax, const bool intercept, const bool warm, std::mt19937& rng,
+          Budget& budget) {
+  arma::vec betaFit = scaleBeta(beta, colMean, colScale);
+  double phi = phi0;
+  int iteT = 0;
+  int status = ilamm(X, rows, colMean, colScale, Y, betaFit, lambda, penalty, lossType, tau, phi0,
+                     gamma, epsilon_c, epsilon_t, iteMax, intercept, "LAMM", -1, warm, rng,
+                     budget, phi, iteT);
+  beta = unscaleBeta(betaFit, colMean, colScale);
+  return status;
+}
+
+// The cross validation of cvNcvxReg, cvNcvxHuberReg and the background jobs over the grid
+// lambdaSeq x tauSeq, followed by the final fit at the chosen cell, which is written to beta on the
+// original scale. An empty lambdaSeq or tauSeq gets the default sequence of nlambda or ntau
+// values, and tauSeq is a single ignored value for the least squares loss. The folds are index
+// views of X with the intercept column, each one standardized on its own rows. The grid is solved
+// as a homotopy on each fold, see cvNcvxHuberReg. The final fit starts from zero, so it doesn't
+// depend on the grid search, and it's cached with fold = -2. cache holds the fits on the full
+// data, and the fits of the cache file if path isn't empty. It's R-free unless checkUser is set,
+// so it can run on a worker thread: the grid search is stopped through cancel and the final fit
+// through abort, both may be NULL, and each cell that's done increments progress if it isn't NULL.
+// timeBudget covers the whole run, iteBudget the grid search and again the final fit. Returns the
+// status as in cvNcvxHuberReg.
+int cvCore(const arma::mat& X, const arma::vec& Y, arma::vec& lambdaSeq, const int nlambda,
+           arma::vec& tauSeq, const int ntau, const std::string lossType,
+           const std::string penalty, const double phi0, const double gamma,
+           const double epsilon_c, const double epsilon_t, const int iteMax, const int nfolds,
+           const bool intercept, const bool standardize, const std::string cvType,
+           std::vector<CacheEntry>& cache, const std::string path,
+           const std::chrono::steady_clock::time_point& start, const double timeBudget,
+           const int iteBudget, const bool checkUser, std::atomic<bool>* cancel,
+           std::atomic<bool>* abort, std::atomic<int>* progress, arma::mat& mse,
+           arma::vec& beta, arma::uword& idxLambda, arma::uword& idxTau, int& iteTotal) {
+  int n = Y.size();
+  int d = X.n_cols - 1;
+  bool alo = cvType == "alo";
+  bool huber = lossType == "Huber";
+  arma::vec zero = arma::zeros(d + 1);
+  arma::vec one = arma::ones(d + 1);
+  // Slots 0 to nf - 1 are the folds, and slot nf is the full data
+  int nf = alo ? 0 : nfolds;
+  int size = alo ? n : n / nf;
+  std::vector<arma::uvec> rowsFit(nf + 1);
+  std::vector<arma::uvec> rowsTest(nf + 1);
+  std::vector<arma::vec> YFit(nf + 1);
+  std::vector<arma::vec> colMean(nf + 1, zero);
+  std::vector<arma::vec> colScale(nf + 1, one);
+  for (int j = 0; j <= nf; j++) {
+    YFit[j] = Y;
+    if (j < nf) {
+      int low = j * size;
+      int up = (j == (nf - 1)) ? (n - 1) : ((j + 1) * size - 1);
+      rowsTest[j] = getIndex(n, low, up);
+      rowsFit[j] = getIndexComp(n, low, up);
+      YFit[j] = Y.rows(rowsFit[j]);
+    }
+    if (standardize) {
+      cmptColScale(X, rowsFit[j], colMean[j], colScale[j], intercept);
+    }
+  }
+  if (lambdaSeq.is_empty()) {
+    arma::vec XtY = cmptXtRes(X, arma::uvec(), colMean[nf], colScale[nf], Y);
+    double lambdaMax = arma::max(arma::abs(XtY)) / n;
+    double lambdaMin = 0.01 * lambdaMax;
+    lambdaSeq = exp(arma::linspace(std::log((long double)lambdaMin),
+                                   std::log((long double)lambdaMax), nlambda));
+  }
+  std::mt19937 rng;
+  int status = 0;
+  // The budget of the grid search is shared by all its fits, the final fit has its own
+  Budget grid = {start, timeBudget, iteBudget, 0, checkUser, cancel};
+  // The default tau's come from the Lasso pilot with the default lambda of ncvxReg on the full
+  // data. It's cached with the reserved tau = 0, which the Huber fits never use, and at infinite
+  // distance from their tau's in findCache.
+  if (huber && tauSeq.is_empty()) {
+    double lambdaPilot = defaultLambda(X, arma::uvec(), colMean[nf], colScale[nf], Y);
+    arma::vec pilot = zero;
+    int hit = findCache(cache, lambdaPilot, 0, -1, true);
+    if (hit >= 0) {
+      pilot = cache[hit].beta;
+    } else {
+      int fitStatus = cvFit(X, arma::uvec(), colMean[nf], colScale[nf], Y, pilot, lambdaPilot,
+                            "Lasso", "l2", 1, phi0, gamma, epsilon_c, epsilon_t, iteMax,
+                            intercept, false, rng, grid);
+      if (fitStatus >= 2) {
+        status = fitStatus;
+      } else if (path != "") {
+        CacheEntry entry = {lambdaPilot, 0, -1, pilot};
+        appendCache(path, entry);
+        cache.push_back(entry);
+      }
+    }
+    arma::vec res = Y - cmptXBeta(X, arma::uvec(), zero, one, pilot);
+    double sigmaHat = arma::median(arma::abs(res - arma::median(res))) / 0.6745;
+    tauSeq = sigmaHat * std::sqrt((long double)(n / std::log((double)n * d))) * tauConst(ntau);
+  }
+  int nl = lambdaSeq.size();
+  int nt = tauSeq.size();
+  mse = arma::mat(nl, nt);
+  mse.fill(arma::datum::nan);
+  arma::vec YPred = arma::zeros(n);
+  // Homotopy over the grid: tau from small to large, and for each tau, lambda from large to small.
+  // The solutions at the current and the previous tau are kept for each slot.
+  arma::uvec lambdaOrder = arma::sort_index(lambdaSeq, "descend");
+  arma::uvec tauOrder = arma::sort_index(tauSeq, "ascend");
+  arma::field<arma::vec> betaCur(nl, nf + 1);
+  arma::field<arma::vec> betaPrev(nl, nf + 1);
+  for (int kk = 0; kk < nt && status == 0; kk++) {
+    int k = tauOrder(kk);
+    double tauKey = huber ? tauSeq(k) : 0;
+    for (int ii = 0; ii < nl && status == 0; ii++) {
+      int i = lambdaOrder(ii);
+      int lambdaPrev = ii > 0 ? (int)lambdaOrder(ii - 1) : -1;
+      double distLambda = arma::datum::inf;
+      if (ii > 0) {
+        distLambda = std::abs(std::log(lambdaSeq(lambdaPrev) / lambdaSeq(i)));
+      }
+      bool fromTau = false;
+      double distTau = arma::datum::inf;
+      if (kk > 0) {
+        distTau = std::abs(std::log(tauSeq(k) / tauSeq(tauOrder(kk - 1))));
+        fromTau = distTau < distLambda;
+      }
+      // ALO scores each cell from the fit on the full data, k-fold from the fits on the folds
+      for (int j = alo ? nf : 0; j < (alo ? nf + 1 : nf); j++) {
+        int fold = j < nf ? j : -1;
+        arma::vec betaHat = arma::vec();
+        int hit = findCache(cache, lambdaSeq(i), tauKey, fold, true);
+        if (hit >= 0) {
+          betaHat = cache[hit].beta;
+        } else {
+          betaHat = homotopyStart(betaCur, betaPrev, i, lambdaPrev, fromTau, j);
+          // A cached fit that's closer than the homotopy neighbour, e.g. from a run on a nearby
+          // grid, is a better start
+          arma::vec betaNear = cacheWarmStart(cache, lambdaSeq(i), tauKey, fold,
+                                              fromTau ? distTau : distLambda);
+          if (!betaNear.is_empty()) {
+            betaHat = betaNear;
+          }
+          bool warm = !betaHat.is_empty();
+          if (!warm) {
+            betaHat = zero;
+          }
+          int fitStatus = cvFit(X, rowsFit[j], colMean[j], colScale[j], YFit[j], betaHat,
+                                lambdaSeq(i), penalty, lossType, tauSeq(k), phi0, gamma,
+                                epsilon_c, epsilon_t, iteMax, intercept, warm, rng, grid);
+          if (fitStatus >= 2) {
+            status = fitStatus;
+            break;
+          }
+          if (fitStatus <= 1 && (path != "" || fold == -1)) {
+            CacheEntry entry = {lambdaSeq(i), tauKey, fold, betaHat};
+            if (path != "") {
+              appendCache(path, entry);
+            }
+            cache.push_back(entry);
+          }
+        }
+        betaCur(i, j) = betaHat;
+        if (!alo) {
+          YPred.rows(rowsTest[j]) = cmptXBeta(X, rowsTest[j], zero, one, betaHat);
+        }
+      }
+      if (status == 0) {
+        if (alo) {
+          mse(i, k) = cmptALO(X, Y, betaCur(i, nf), lossType, tauSeq(k), intercept);
+        } else {
+          mse(i, k) = arma::norm(Y - YPred, 2);
+        }
+        if (progress != NULL) {
+          progress->fetch_add(1);
+        }
+      }
+    }
+    std::swap(betaCur, betaPrev);
+  }
+  iteTotal += grid.iteTotal;
+  // If the search was stopped, choose among the evaluated cells, or the largest lambda with the
+  // middle tau if none
+  arma::uvec evaluated = arma::find_finite(mse);
+  idxLambda = lambdaSeq.index_max();
+  idxTau = (nt - 1) / 2;
+  if (!evaluated.is_empty()) {
+    arma::vec mseEval = mse.elem(evaluated);
+    arma::uword cvIdx = evaluated(mseEval.index_min());
+    idxLambda = cvIdx - (cvIdx / nl) * nl;
+    idxTau = cvIdx / nl;
+  }
+  // The final fit is the one of ncvxReg or ncvxHuberReg at the chosen cell, from zero and with its
+  // own stop flag, so a cancelled grid search still ends with a real fit
+  double tauKey = huber ? tauSeq(idxTau) : 0;
+  int hit = findCache(cache, lambdaSeq(idxLambda), tauKey, -2, true);
+  if (hit >= 0) {
+    beta = cache[hit].beta;
+    return status;
+  }
+  beta = zero;
+  Budget budget = {start, timeBudget, iteBudget, 0, checkUser, abort};
+  int fitStatus = cvFit(X, arma::uvec(), colMean[nf], colScale[nf], Y, beta, lambdaSeq(idxLambda),
+                        penalty, lossType, tauSeq(idxTau), phi0, gamma, epsilon_c, epsilon_t,
+                        iteMax, intercept, false, rng, budget);
+  iteTotal += budget.iteTotal;
+  if (status == 0) {
+    status = fitStatus;
+  }
+  if (path != "" && fitStatus <= 1) {
+    CacheEntry entry = {lambdaSeq(idxLambda), tauKey, -2, beta};
+    appendCache(path, entry);
+  }
+  return status;
+}
+
 //' The function performs k-fold cross validation for (high-dimensional) regularized regression with non-convex penalties: Lasso, SCAD and MCP, and it's implemented via I-LAMM algorithm.
 //'
 //' The observed data are \eqn{(Y, X)}, where \eqn{Y} is an \eqn{n}-dimensional response vector and \eqn{X} is an \eqn{n} by \eqn{d} design matrix. We assume that \eqn{Y} depends on \eqn{X} through a linear model \eqn{Y = X \beta + \epsilon}, where \eqn{\epsilon} is an \eqn{n}-dimensional noise vector whose distribution can be asymmetrix and/or heavy-tailed. The design matrix \eqn{X} can be either high-dimensional or low-dimensional. The sequence of \eqn{\lambda}'s has a default setting but it can be user-specified. All the arguments except for \eqn{X} and \eqn{Y} have default settings.
 //'
+//' The \eqn{\lambda}'s are solved on each fold from large to small, and each fit is warm started from the fit at the previous \eqn{\lambda}, the first one from zero.
+//'
 //' @title K-fold cross validation for non-convex regularized regression
 //' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, either low-dimensional data (\eqn{d \le n}) or high-dimensional data (\eqn{d > n}) are allowed.
 //' @param Y A continuous response vector with length \eqn{n}.
@@ -402,14 +1420,21 @@ arma::vec tauConst(int n) {
 //' @param nfolds The number of folds to conduct cross validation, values that are greater than 10 are not recommended, and it'll be modified to 10 if the input is greater than 10. The default value is 3.
 //' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
 //' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting. The columns are centered (if \code{intercept = TRUE}) and scaled implicitly inside the I-LAMM iterations without copying \eqn{X}, so \eqn{\lambda} is applied on the standardized scale, and the returned \code{beta} is on the original scale. It usually reduces the number of iterations a lot when the columns of \eqn{X} have very different scales. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the whole cross validation in seconds, including the final fit. The grid search stops at the first check after it's exceeded, and \code{lambdaMin} is chosen among the evaluated grid values. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations of the grid search, over all its fits. The grid search stops once it's exhausted, and \code{lambdaMin} is chosen among the evaluated grid values as with \code{timeBudget}. The final fit has a budget of \code{iteBudget} iterations of its own. Non-positive values mean no limit. The default value is -1.
+//' @param cacheDir Optional path of an existing directory to checkpoint the cross validation. The fit on each fold at each grid value is appended to a file named by a hash of \eqn{X}, \eqn{Y}, the fold assignment and the solver settings, so an interrupted run resumes where it stopped, and a repeated run on the same data only computes the grid values that are not cached yet. Fits that are not cached are warm started along the \eqn{\lambda} path, see details, or from the cached fit of the same fold at the nearest grid value if it's closer. The directory is checked to be writable before the grid search starts, and the records of a cache file that don't match the dimension of \eqn{X} are dropped. The default setting \code{""} means no checkpointing.
+//' @param cvType The type of cross validation, possible choices are "kfold" (default), which refits the model on \code{nfolds} - 1 folds for each \eqn{\lambda}, and "alo", which fits the model once on the full data for each \eqn{\lambda} and approximates the leave-one-out errors from that fit. The approximation takes the fit as the solution of its last reweighted problem restricted to its support, and it only needs a factorization of the size of the support, so "alo" is about \code{nfolds} times cheaper. \code{nfolds} is ignored if \code{cvType = "alo"}.
 //' @return A list including the following terms will be returned:
 //' \itemize{
-//' \item \code{beta} The estimated \eqn{\beta} with \eqn{\lambda} determined by cross validation, it's a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}).
+//' \item \code{beta} The estimated \eqn{\beta} with \eqn{\lambda} determined by cross validation, it's a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}). It's fitted on the full data from zero, so it's the \code{beta} of \code{ncvxReg} with \code{lambdaMin}, whatever the grid search did.
 //' \item \code{penalty} The type of penalty.
 //' \item \code{lambdaSeq} The sequence of \eqn{\lambda}'s for cross validation.
-//' \item \code{mse} The mean squared error from cross validation, it's a vector with length \code{nlambda}.
+//' \item \code{mse} The mean squared error from cross validation, it's a vector with length \code{nlambda}. With \code{cvType = "alo"}, it's the approximate leave-one-out error, and it's \code{Inf} if the fit interpolates the data on its support.
 //' \item \code{lambdaMin} The value of \eqn{\lambda} in \code{lambdaSeq} that minimized \code{mse}.
 //' \item \code{nfolds} The number of folds for cross validation.
+//' \item \code{iteTotal} The total number of LAMM iterations of all the fits, including the final fit. Cached fits take no iterations.
+//' \item \code{status} 2 if the grid search was stopped by \code{iteBudget}, 3 if it was stopped by \code{timeBudget}, 4 if it was interrupted by the user, or 5 if the step size search of a fit failed, then the values of \code{mse} that were not evaluated are \code{NA}. Otherwise it's the status of the final fit, see the fitting function. An interrupt only stops the grid search, the final fit can be interrupted again.
 //' }
 //' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
 //' @references Fan, J., Liu, H., Sun, Q. and Zhang, T. (2018). I-LAMM for sparse learning: Simultaneous control of algorithmic complexity and statistical error. Ann. Statist. 46 814–841.
@@ -436,7 +1461,15 @@ Rcpp::List cvNcvxReg(arma::mat& X, const arma::vec& Y,
                     const std::string penalty = "SCAD", const double phi0 = 0.001,
                     const double gamma = 1.5, const double epsilon_c = 0.0001,
                     const double epsilon_t = 0.0001, const int iteMax = 500, int nfolds = 3,
-                    const bool intercept = false, const bool itcpIncluded = false) {
+                    const bool intercept = false, const bool itcpIncluded = false,
+                    const bool standardize = false, const double timeBudget = -1,
+                    const int iteBudget = -1, const std::string cacheDir = "",
+                    const std::string cvType = "kfold") {
+  checkData(X, Y);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if (cvType != "kfold" && cvType != "alo") {
+    Rcpp::stop("cvType must be \"kfold\" or \"alo\"");
+  }
   if (!itcpIncluded) {
     arma::mat XX = arma::ones(X.n_rows, X.n_cols + 1);
     XX.cols(1, X.n_cols) = X;
@@ -447,53 +1480,50 @@ Rcpp::List cvNcvxReg(arma::mat& X, const arma::vec& Y,
   if (lSeq.isNotNull()) {
     lambdaSeq = Rcpp::as<arma::vec>(lSeq);
     nlambda = lambdaSeq.size();
-  } else {
-    double lambdaMax = arma::max(arma::abs(Y.t() * X)) / n;
-    double lambdaMin = 0.01 * lambdaMax;
-    lambdaSeq = exp(arma::linspace(std::log((long double)lambdaMin),
-                                   std::log((long double)lambdaMax), nlambda));
   }
-  if (nfolds > 10 || nfolds > n) {
+  // nfolds is ignored by ALO
+  if (cvType == "kfold" && (nfolds > 10 || nfolds > n)) {
     nfolds = n < 10 ? n : 10;
     std::cout << "Number of folds is too large, we'll set it to be: " << nfolds << std::endl;
   }
-  int size = n / nfolds;
-  arma::vec YPred = arma::zeros(n);
-  arma::vec beta = arma::zeros(X.n_cols);
-  arma::vec mse = arma::zeros(nlambda);
-  for (int i = 0; i < nlambda; i++) {
-    for (int j = 0; j < nfolds; j++) {
-      int low = j * size;
-      int up = (j == (nfolds - 1)) ? (n - 1) : ((j + 1) * size - 1);
-      arma::uvec idx = getIndex(n, low, up);
-      arma::uvec idxComp = getIndexComp(n, low, up);
-      Rcpp::List listILAMM = ncvxReg(X.rows(idxComp), Y.rows(idxComp), lambdaSeq(i), penalty,
-                                     phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, true);
-      arma::vec betaHat = Rcpp::as<arma::vec>(listILAMM["beta"]);
-      YPred.rows(idx) = X.rows(idx) * betaHat;
-    }
-    mse(i) = arma::norm(Y - YPred, 2);
-  }
-  arma::uword cvIdx = mse.index_min();
-  Rcpp::List listILAMM = ncvxReg(X, Y, lambdaSeq(cvIdx), penalty, phi0, gamma, epsilon_c,
-                                 epsilon_t, iteMax, intercept, true);
-  beta = Rcpp::as<arma::vec>(listILAMM["beta"]);
+  std::string path = "";
+  std::vector<CacheEntry> cache;
+  if (cacheDir != "") {
+    path = cachePath(cacheDir, X, Y, nfolds, "l2", penalty, phi0, gamma, epsilon_c, epsilon_t,
+                     iteMax, intercept, standardize);
+    cache = openCache(path, X.n_cols);
+  }
+  arma::vec tauSeq = arma::ones(1);
+  arma::mat mse = arma::mat();
+  arma::vec beta = arma::vec();
+  arma::uword idxLambda = 0;
+  arma::uword idxTau = 0;
+  int iteTotal = 0;
+  int status = cvCore(X, Y, lambdaSeq, nlambda, tauSeq, 1, "l2", penalty, phi0, gamma, epsilon_c,
+                      epsilon_t, iteMax, nfolds, intercept, standardize, cvType, cache, path,
+                      start, timeBudget, iteBudget, true, NULL, NULL, NULL, mse, beta, idxLambda,
+                      idxTau, iteTotal);
   return Rcpp::List::create(Rcpp::Named("beta") = beta, Rcpp::Named("penalty") = penalty,
-                            Rcpp::Named("lambdaSeq") = lambdaSeq, Rcpp::Named("mse") = mse,
-                            Rcpp::Named("lambdaMin") = lambdaSeq(cvIdx), Rcpp::Named("nfolds") = nfolds);
+                            Rcpp::Named("lambdaSeq") = lambdaSeq,
+                            Rcpp::Named("mse") = arma::vec(mse.col(0)),
+                            Rcpp::Named("lambdaMin") = lambdaSeq(idxLambda),
+                            Rcpp::Named("nfolds") = nfolds, Rcpp::Named("iteTotal") = iteTotal,
+                            Rcpp::Named("status") = status);
 }
 
 //' The function performs k-fold cross validation for (high-dimensional) Huber regularized regression with non-convex penalties: Lasso, SCAD and MCP, and it's implemented via I-LAMM algorithm.
 //'
 //' The observed data are \eqn{(Y, X)}, where \eqn{Y} is an \eqn{n}-dimensional response vector and \eqn{X} is an \eqn{n} by \eqn{d} design matrix. We assume that \eqn{Y} depends on \eqn{X} through a linear model \eqn{Y = X \beta + \epsilon}, where \eqn{\epsilon} is an \eqn{n}-dimensional noise vector whose distribution can be asymmetrix and/or heavy-tailed. The design matrix \eqn{X} can be either high-dimensional or low-dimensional. The sequence of \eqn{\lambda}'s and \eqn{\tau}'s have default settings but they can be user-specified. All the arguments except for \eqn{X} and \eqn{Y} have default settings.
 //'
+//' The grid is solved as a homotopy on each fold: \eqn{\tau} goes from small to large, and for each \eqn{\tau}, \eqn{\lambda} goes from large to small. Each fit is warm started from its nearest solved neighbour on log scale, which is the previous \eqn{\lambda} with the same \eqn{\tau} or the same \eqn{\lambda} with the previous \eqn{\tau}, and the first fit on each fold, at the largest \eqn{\lambda} and the smallest \eqn{\tau}, starts from zero. Without \code{tSeq}, a Lasso fit on the full data with the default \eqn{\lambda} of \code{ncvxReg} gives the default \code{tSeq}. Neighbouring fits share most of their support, and a warm started fit skips the contraction stage (see \code{betaInit} in \code{ncvxHuberReg}), so it usually takes a small fraction of the iterations of a fit from zero.
+//'
 //' @title K-fold cross validation for non-convex regularized Huber regression
 //' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, either low-dimensional data (\eqn{d \le n}) or high-dimensional data (\eqn{d > n}) are allowed.
 //' @param Y A continuous response vector with length \eqn{n}.
 //' @param lSeq Sequence of tuning parameter of regularized regression \eqn{\lambda}, every element should be positive. If it's not specified, the default sequence is generated in this way: define \eqn{\lambda_max = max(|Y^T X|) / n}, and \eqn{\lambda_min = 0.01 * \lambda_max}, then \code{lseq} is a sequence from \eqn{\lambda_max} to \eqn{\lambda_min} that decreases uniformly on log scale.
 //' @param nlambda Number of \eqn{\lambda} to generate the default sequence \code{lSeq}. It's not necessary if \code{lSeq} is specified. The default value is 30.
 //' @param penalty Type of non-convex penalties with default setting "SCAD", possible choices are: "Lasso", "SCAD" and "MCP".
-//' @param tSeq Sequence of robustness parameter of Huber loss \eqn{\tau}, every element should be positive. If it's not specified, the default sequence is generated in this way: define \eqn{R} as the residual from Lasso by fitting \code{cvNcvxReg} with \code{lSeq}, and \eqn{\sigma_MAD = median(|R - median(R)|) / \Phi^(-1)(3/4)} is the median absolute deviation estimator, then \code{tSeq} = \eqn{2^j * \sigma_MAD \sqrt(n / log(nd))}, where \eqn{j} are integers from -\code{ntau}/2 to \code{ntau}/2.
+//' @param tSeq Sequence of robustness parameter of Huber loss \eqn{\tau}, every element should be positive. If it's not specified, the default sequence is generated in this way: define \eqn{R} as the residual from Lasso by fitting \code{ncvxReg} with its default \eqn{\lambda}, and \eqn{\sigma_MAD = median(|R - median(R)|) / \Phi^(-1)(3/4)} is the median absolute deviation estimator, then \code{tSeq} = \eqn{2^j * \sigma_MAD \sqrt(n / log(nd))}, where \eqn{j} are integers from -\code{ntau}/2 to \code{ntau}/2.
 //' @param ntau Number of \eqn{\tau} to generate the default sequence \code{tSeq}. It's not necessary if \code{tSeq} is specified. The default value is 5.
 //' @param phi0 The initial value of the isotropic parameter \eqn{\phi} in I-LAMM algorithm. The defalut value is 0.001.
 //' @param gamma The inflation parameter in I-LAMM algorithm, in each iteration of I-LAMM, we will inflate \eqn{\phi} by \eqn{\gamma}. The defalut value is 1.5.
@@ -503,16 +1533,23 @@ Rcpp::List cvNcvxReg(arma::mat& X, const arma::vec& Y,
 //' @param nfolds The number of folds to conduct cross validation, values that are greater than 10 are not recommended, and it'll be modified to 10 if the input is greater than 10. The default value is 3.
 //' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
 //' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting. The columns are centered (if \code{intercept = TRUE}) and scaled implicitly inside the I-LAMM iterations without copying \eqn{X}, so \eqn{\lambda} is applied on the standardized scale, and the returned \code{beta} is on the original scale. It usually reduces the number of iterations a lot when the columns of \eqn{X} have very different scales. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the whole cross validation in seconds, including the final fit. The grid search stops at the first check after it's exceeded, and \code{lambdaMin} is chosen among the evaluated grid values. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations of the grid search, over all its fits including the Lasso fit. The grid search stops once it's exhausted, and \code{lambdaMin} is chosen among the evaluated grid values as with \code{timeBudget}. The final fit has a budget of \code{iteBudget} iterations of its own. Non-positive values mean no limit. The default value is -1.
+//' @param cacheDir Optional path of an existing directory to checkpoint the cross validation. The fit on each fold at each grid value is appended to a file named by a hash of \eqn{X}, \eqn{Y}, the fold assignment and the solver settings, so an interrupted run resumes where it stopped, and a repeated run on the same data only computes the grid values that are not cached yet. The Lasso fit is cached as well. Fits that are not cached are warm started along the homotopy, see details, or from the cached fit of the same fold at the nearest grid value if it's closer. The directory is checked to be writable before the grid search starts, and the records of a cache file that don't match the dimension of \eqn{X} are dropped. The default setting \code{""} means no checkpointing.
+//' @param cvType The type of cross validation, possible choices are "kfold" (default), which refits the model on \code{nfolds} - 1 folds for each pair of \eqn{\lambda} and \eqn{\tau}, and "alo", which fits the model once on the full data for each pair of \eqn{\lambda} and \eqn{\tau} and approximates the leave-one-out errors from that fit. The approximation takes the fit as the solution of its last reweighted problem restricted to its support, with the weights of the Huber loss, and it only needs a factorization of the size of the support, so "alo" is about \code{nfolds} times cheaper. \code{nfolds} is ignored if \code{cvType = "alo"}.
 //' @return A list including the following terms will be returned:
 //' \itemize{
-//' \item \code{beta} The estimated \eqn{\beta} with \eqn{\lambda} and \eqn{\tau} determined by cross validation, it's a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}).
+//' \item \code{beta} The estimated \eqn{\beta} with \eqn{\lambda} and \eqn{\tau} determined by cross validation, it's a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}). It's fitted on the full data from zero, so it's the \code{beta} of \code{ncvxHuberReg} with \code{lambdaMin} and \code{tauMin}, whatever the grid search did.
 //' \item \code{penalty} The type of penalty.
 //' \item \code{lambdaSeq} The sequence of \eqn{\lambda}'s for cross validation.
 //' \item \code{tauSeq} The sequence of \eqn{\tau}'s for cross validation.
-//' \item \code{mse} The mean squared error from cross validation, it's a matrix with dimension \code{nlambda} by \code{ntau}.
+//' \item \code{mse} The mean squared error from cross validation, it's a matrix with dimension \code{nlambda} by \code{ntau}. With \code{cvType = "alo"}, it's the approximate leave-one-out error, and it's \code{Inf} if the fit interpolates the inliers on its support.
 //' \item \code{lambdaMin} The value of \eqn{\lambda} in \code{lSeq} that minimized \code{mse}.
 //' \item \code{tauMin} The value of \eqn{\tau} in \code{tSeq} that minimized \code{mse}.
 //' \item \code{nfolds} The number of folds for cross validation.
+//' \item \code{iteTotal} The total number of LAMM iterations of all the fits, including the Lasso fit and the final fit. Cached fits take no iterations.
+//' \item \code{status} 2 if the grid search was stopped by \code{iteBudget}, 3 if it was stopped by \code{timeBudget}, 4 if it was interrupted by the user, or 5 if the step size search of a fit failed, then the values of \code{mse} that were not evaluated are \code{NA}. Otherwise it's the status of the final fit, see the fitting function. An interrupt only stops the grid search, the final fit can be interrupted again.
 //' }
 //' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
 //' @references Fan, J., Liu, H., Sun, Q. and Zhang, T. (2018). I-LAMM for sparse learning: Simultaneous control of algorithmic complexity and statistical error. Ann. Statist. 46 814–841.
@@ -543,71 +1580,976 @@ Rcpp::List cvNcvxHuberReg(arma::mat& X, const arma::vec& Y,
                   const double phi0 = 0.001, const double gamma = 1.5,
                   const double epsilon_c = 0.0001, const double epsilon_t = 0.0001,
                   const int iteMax = 500, int nfolds = 3, const bool intercept = false,
-                  const bool itcpIncluded = false) {
+                  const bool itcpIncluded = false, const bool standardize = false,
+                  const double timeBudget = -1, const int iteBudget = -1,
+                  const std::string cacheDir = "", const std::string cvType = "kfold") {
+  checkData(X, Y);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if (cvType != "kfold" && cvType != "alo") {
+    Rcpp::stop("cvType must be \"kfold\" or \"alo\"");
+  }
   if (!itcpIncluded) {
     arma::mat XX = arma::ones(X.n_rows, X.n_cols + 1);
     XX.cols(1, X.n_cols) = X;
     X = XX;
   }
   int n = Y.size();
-  int d = X.n_cols - 1;
   arma::vec lambdaSeq = arma::vec();
   if (lSeq.isNotNull()) {
     lambdaSeq = Rcpp::as<arma::vec>(lSeq);
     nlambda = lambdaSeq.size();
-  } else {
-    double lambdaMax = arma::max(arma::abs(Y.t() * X)) / n;
-    double lambdaMin = 0.01 * lambdaMax;
-    lambdaSeq = exp(arma::linspace(std::log((long double)lambdaMin),
-                    std::log((long double)lambdaMax), nlambda));
   }
   arma::vec tauSeq = arma::vec();
   if (tSeq.isNotNull()) {
     tauSeq = Rcpp::as<arma::vec>(tSeq);
     ntau = tauSeq.size();
-  } else {
-    Rcpp::List listILAMM = cvNcvxReg(X, Y, lSeq, nlambda, "Lasso", phi0, gamma, epsilon_c,
-                                     epsilon_t, iteMax, nfolds, intercept, true);
-    arma::vec betaLasso = Rcpp::as<arma::vec>(listILAMM["beta"]);
-    arma::vec Yhat = X * betaLasso;
-    arma::vec res = Y - Yhat;
-    double sigmaHat = arma::median(arma::abs(res - arma::median(res))) / 0.6745;
-    arma::vec tauCon = tauConst(ntau);
-    tauSeq = sigmaHat * std::sqrt((long double)(n / std::log(n * d))) * tauCon;
   }
-  if (nfolds > 10 || nfolds > n) {
+  // nfolds is ignored by ALO
+  if (cvType == "kfold" && (nfolds > 10 || nfolds > n)) {
     nfolds = n < 10 ? n : 10;
     std::cout << "Number of folds is too big, we'll set it to be: " << nfolds << std::endl;
   }
-  int size = n / nfolds;
-  arma::vec YPred = arma::zeros(n);
-  arma::vec beta = arma::zeros(X.n_cols);
-  arma::mat mse = arma::zeros(nlambda, ntau);
-  for (int i = 0; i < nlambda; i++) {
-    for (int k = 0; k < ntau; k++) {
-      for (int j = 0; j < nfolds; j++) {
-        int low = j * size;
-        int up = (j == (nfolds - 1)) ? (n - 1) : ((j + 1) * size - 1);
-        arma::uvec idx = getIndex(n, low, up);
-        arma::uvec idxComp = getIndexComp(n, low, up);
-        Rcpp::List listILAMM = ncvxHuberReg(X.rows(idxComp), Y.rows(idxComp), lambdaSeq(i),
-                                            penalty, tauSeq(k), phi0, gamma, epsilon_c, epsilon_t,
-                                            iteMax, intercept, true);
-        arma::vec betaHat = Rcpp::as<arma::vec>(listILAMM["beta"]);
-        YPred.rows(idx) = X.rows(idx) * betaHat;
-      }
-      mse(i, k) = arma::norm(Y - YPred, 2);
-    }
+  std::string path = "";
+  std::vector<CacheEntry> cache;
+  if (cacheDir != "") {
+    path = cachePath(cacheDir, X, Y, nfolds, "Huber", penalty, phi0, gamma, epsilon_c, epsilon_t,
+                     iteMax, intercept, standardize);
+    cache = openCache(path, X.n_cols);
   }
-  arma::uword cvIdx = mse.index_min();
-  arma::uword idxLambda = cvIdx - (cvIdx / nlambda) * nlambda;
-  arma::uword idxTau = cvIdx / nlambda;
-  Rcpp::List listILAMM = ncvxHuberReg(X, Y, lambdaSeq(idxLambda), penalty, tauSeq(idxTau), phi0,
-                                      gamma, epsilon_c, epsilon_t, iteMax, intercept, true);
-  beta = Rcpp::as<arma::vec>(listILAMM["beta"]);
+  arma::mat mse = arma::mat();
+  arma::vec beta = arma::vec();
+  arma::uword idxLambda = 0;
+  arma::uword idxTau = 0;
+  int iteTotal = 0;
+  int status = cvCore(X, Y, lambdaSeq, nlambda, tauSeq, ntau, "Huber", penalty, phi0, gamma,
+                      epsilon_c, epsilon_t, iteMax, nfolds, intercept, standardize, cvType, cache,
+                      path, start, timeBudget, iteBudget, true, NULL, NULL, NULL, mse, beta,
+                      idxLambda, idxTau, iteTotal);
   return Rcpp::List::create(Rcpp::Named("beta") = beta, Rcpp::Named("penalty") = penalty,
                             Rcpp::Named("lambdaSeq") = lambdaSeq, Rcpp::Named("tauSeq") = tauSeq,
-                            Rcpp::Named("mse") = mse, Rcpp::Named("lambdaMin") = lambdaSeq(idxLambda),
-                            Rcpp::Named("tauMin") = tauSeq(idxTau), Rcpp::Named("nfolds") = nfolds);
+                            Rcpp::Named("mse") = mse,
+                            Rcpp::Named("lambdaMin") = lambdaSeq(idxLambda),
+                            Rcpp::Named("tauMin") = tauSeq(idxTau), Rcpp::Named("nfolds") = nfolds,
+                            Rcpp::Named("iteTotal") = iteTotal, Rcpp::Named("status") = status);
+}
+
+
+// Rows of a random subsample of size m out of n, drawn with replacement for the bootstrap, sorted
+// so that the index view reads each column of X in order
+arma::uvec sampleRows(const int n, const int m, const bool replace, std::mt19937& rng) {
+  arma::uvec rst = arma::uvec(m);
+  if (replace) {
+    std::uniform_int_distribution<int> unif(0, n - 1);
+    for (int i = 0; i < m; i++) {
+      rst(i) = unif(rng);
+    }
+  } else {
+    arma::uvec perm = arma::regspace<arma::uvec>(0, n - 1);
+    for (int i = 0; i < m; i++) {
+      std::uniform_int_distribution<int> unif(i, n - 1);
+      std::swap(perm(i), perm(unif(rng)));
+    }
+    rst = perm.head(m);
+  }
+  return arma::sort(rst);
+}
+
+// Quantile of the sorted vector x at level p, interpolated as the default type of quantile in R
+double quantileSorted(const arma::vec& x, const double p) {
+  double h = (x.size() - 1) * p;
+  int low = (int)std::floor(h);
+  int up = std::min(low + 1, (int)x.size() - 1);
+  return x(low) + (h - low) * (x(up) - x(low));
+}
+
+//' The function runs non-convex regularized Huber regression on random subsamples or bootstrap samples of the data in parallel, and returns the selection frequency and the quantiles of each coefficient, for stability selection and bootstrap inference.
+//'
+//' The observed data are \eqn{(Y, X)}, where \eqn{Y} is an \eqn{n}-dimensional response vector and \eqn{X} is an \eqn{n} by \eqn{d} design matrix. The tuning parameters \eqn{\lambda} and \eqn{\tau} are determined once on the full data, as in \code{ncvxHuberReg}, then \code{ncvxHuberReg} is fitted with them on each sample. All the samples share the design matrix through row indices instead of copying it, and every fit is warm started from the fit on the full data. The fits run on \code{nthreads} threads via OpenMP, and each sample is drawn from its own seed taken from R's random number generator, so \code{set.seed} makes the result reproducible with any number of threads. All the arguments except for \eqn{X} and \eqn{Y} have default settings.
+//'
+//' @title Stability selection and bootstrap for non-convex regularized Huber regression
+//' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, either low-dimensional data (\eqn{d \le n}) or high-dimensional data (\eqn{d > n}) are allowed.
+//' @param Y A continuous response vector with length \eqn{n}.
+//' @param lambda Tuning parameter of regularized regression, its specified value should be positive. The default value is the one of \code{ncvxHuberReg} on the full data.
+//' @param penalty Type of non-convex penalties with default setting "SCAD", possible choices are: "Lasso", "SCAD" and "MCP".
+//' @param tau Robustness parameter of Huber loss function, its specified value should be positive. The default value is the one of \code{ncvxHuberReg} on the full data.
+//' @param nboot The number of samples, a positive integer. The default value is 100.
+//' @param method The way to draw the samples, possible choices are "subsample" (default), which draws \code{sampleRate} * \eqn{n} rows without replacement as in stability selection, and "bootstrap", which draws \eqn{n} rows with replacement.
+//' @param sampleRate The fraction of rows in each subsample when \code{method = "subsample"}, in (0, 1]. The default value is 0.5.
+//' @param probs Levels of the quantiles of the coefficients, in [0, 1]. The default setting \code{NULL} means \code{c(0.05, 0.5, 0.95)}.
+//' @param phi0 The initial value of the isotropic parameter \eqn{\phi} in I-LAMM algorithm. The defalut value is 0.001.
+//' @param gamma The inflation parameter in I-LAMM algorithm, in each iteration of I-LAMM, we will inflate \eqn{\phi} by \eqn{\gamma}. The defalut value is 1.5.
+//' @param epsilon_c The tolerance level for contraction stage, iteration of contraction will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_c}. The defalut value is 1e-4.
+//' @param epsilon_t The tolerance level for tightening stage, iteration of tightening will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_t}. The defalut value is 1e-4.
+//' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
+//' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
+//' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting, see \code{ncvxHuberReg}. The columns are standardized once on the full data. The default setting is \code{FALSE}.
+//' @param nthreads The number of threads to fit the samples. The default value 0 means the OpenMP default, usually the number of cores. It's ignored if the package is built without OpenMP.
+//' @param timeBudget The wall-clock time budget of the whole run in seconds, including the fit on the full data. The samples that are not finished when it's exceeded are left out. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations of each fit, see \code{ncvxHuberReg}. Non-positive values mean no limit. The default value is -1.
+//' @return A list including the following terms will be returned:
+//' \itemize{
+//' \item \code{beta} The estimated \eqn{\beta} on the full data, a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}).
+//' \item \code{freq} The selection frequency of each coefficient, i.e. the fraction of the samples where it's nonzero, a vector with length d + 1, with the first one being the intercept.
+//' \item \code{quantiles} The quantiles of the coefficients over the samples, a matrix with dimension d + 1 by \code{length(probs)}.
+//' \item \code{probs} The levels of the quantiles.
+//' \item \code{penalty} The type of penalty.
+//' \item \code{lambda} The value of \eqn{\lambda}.
+//' \item \code{tau} The value of \eqn{\tau}.
+//' \item \code{nboot} The number of samples.
+//' \item \code{nsample} The number of rows in each sample.
+//' \item \code{status} The status of the fit on the full data, see \code{ncvxHuberReg}.
+//' \item \code{statusBoot} The status of the fit on each sample, see \code{ncvxHuberReg}, where 3 and 4 also mark the samples that were left out by \code{timeBudget} or a user interrupt. \code{freq} and \code{quantiles} are computed over the samples with status at most 2, and they're \code{NA} if there is none.
+//' }
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @references Fan, J., Liu, H., Sun, Q. and Zhang, T. (2018). I-LAMM for sparse learning: Simultaneous control of algorithmic complexity and statistical error. Ann. Statist. 46 814–841.
+//' @references Meinshausen, N. and Buhlmann, P. (2010). Stability selection. J. R. Stat. Soc. Ser. B. Stat. Methodol. 72 417–473.
+//' @seealso \code{\link{ncvxHuberReg}}
+//' @examples
+//' n = 50
+//' d = 100
+//' set.seed(2018)
+//' X = matrix(rnorm(n * d), n, d)
+//' beta = c(rep(2, 3), rep(0, d - 3))
+//' Y = X %*% beta + rlnorm(n, 0, 1.2) - exp(1.2^2 / 2)
+//' # Stability selection of Huber-SCAD on 20 half subsamples with 2 threads
+//' fit = bootNcvxHuberReg(X, Y, nboot = 20, nthreads = 2)
+//' which(fit$freq >= 0.8)
+//' # Bootstrap quantiles of Huber-MCP with intercept
+//' fit = bootNcvxHuberReg(X, Y, penalty = "MCP", nboot = 20, method = "bootstrap",
+//'                        intercept = TRUE, nthreads = 2)
+//' fit$quantiles[1:5, ]
+//' @export
+// [[Rcpp::export]]
+Rcpp::List bootNcvxHuberReg(arma::mat X, const arma::vec& Y, double lambda = -1,
+                            std::string penalty = "SCAD", double tau = -1,
+                            const int nboot = 100, const std::string method = "subsample",
+                            const double sampleRate = 0.5,
+                            Rcpp::Nullable<Rcpp::NumericVector> probs = R_NilValue,
+                            const double phi0 = 0.001, const double gamma = 1.5,
+                            const double epsilon_c = 0.0001, const double epsilon_t = 0.0001,
+                            const int iteMax = 500, const bool intercept = false,
+                            const bool itcpIncluded = false, const bool standardize = false,
+                            const int nthreads = 0, const double timeBudget = -1,
+                            const int iteBudget = -1) {
+  checkData(X, Y);
+  if (method != "subsample" && method != "bootstrap") {
+    Rcpp::stop("method must be \"subsample\" or \"bootstrap\"");
+  }
+  if (!(sampleRate > 0 && sampleRate <= 1)) {
+    Rcpp::stop("sampleRate must be in (0, 1]");
+  }
+  if (nboot <= 0) {
+    Rcpp::stop("nboot must be positive");
+  }
+  arma::vec probSeq = {0.05, 0.5, 0.95};
+  if (probs.isNotNull()) {
+    probSeq = Rcpp::as<arma::vec>(probs);
+  }
+  if (!probSeq.is_finite() || arma::any(probSeq < 0) || arma::any(probSeq > 1)) {
+    Rcpp::stop("probs must be in [0, 1]");
+  }
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if (!itcpIncluded) {
+    arma::mat XX = arma::ones(X.n_rows, X.n_cols + 1);
+    XX.cols(1, X.n_cols) = X;
+    X = XX;
+  }
+  int n = Y.size();
+  int d = X.n_cols - 1;
+  arma::vec colMean = arma::zeros(d + 1);
+  arma::vec colScale = arma::ones(d + 1);
+  if (standardize) {
+    cmptColScale(X, arma::uvec(), colMean, colScale, intercept);
+  }
+  // The tuning parameters and the warm start from the full data, on the main thread
+  if (lambda <= 0) {
+    lambda = defaultLambda(X, arma::uvec(), colMean, colScale, Y);
+  }
+  std::mt19937 rng;
+  Budget budget = {start, timeBudget, iteBudget, 0, true, NULL};
+  int status = 0;
+  if (tau <= 0) {
+    status = defaultTau(X, colMean, colScale, Y, lambda, phi0, gamma, epsilon_c, epsilon_t,
+                        iteMax, intercept, "LAMM", -1, rng, budget, tau);
+  }
+  arma::vec betaFull = arma::zeros(d + 1);
+  double phi = phi0;
+  int iteT = 0;
+  if (status <= 2) {
+    status = ilamm(X, arma::uvec(), colMean, colScale, Y, betaFull, lambda, penalty, "Huber", tau,
+                   phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, "LAMM", -1, false, rng,
+                   budget, phi, iteT);
+  }
+  bool replace = method == "bootstrap";
+  int m = replace ? n : std::min(std::max((int)(sampleRate * n), 2), n);
+  std::vector<unsigned int> seeds(nboot);
+  for (int b = 0; b < nboot; b++) {
+    seeds[b] = (unsigned int)(R::unif_rand() * 4294967295.0);
+  }
+  arma::mat betaBoot = arma::mat(d + 1, nboot);
+  betaBoot.fill(arma::datum::nan);
+  arma::ivec statusBoot = arma::ivec(nboot);
+  statusBoot.fill(0);
+  // Thread 0 is the calling thread, it alone checks for user interrupts and cancels the others
+  std::atomic<bool> cancel(status == 4);
+  std::atomic<bool> failed(false);
+  int nt = 1;
+#ifdef _OPENMP
+  nt = nthreads > 0 ? nthreads : omp_get_max_threads();
+#pragma omp parallel for num_threads(nt) schedule(dynamic)
+#endif
+  for (int b = 0; b < nboot; b++) {
+    if (cancel.load()) {
+      statusBoot(b) = 4;
+      continue;
+    }
+    if (timeBudget > 0 && elapsedTime(start) >= timeBudget) {
+      statusBoot(b) = 3;
+      continue;
+    }
+    bool mainThread = true;
+#ifdef _OPENMP
+    mainThread = omp_get_thread_num() == 0;
+#endif
+    try {
+      std::mt19937 rngBoot(seeds[b]);
+      arma::uvec rows = sampleRows(n, m, replace, rngBoot);
+      arma::vec YBoot = Y.rows(rows);
+      arma::vec beta = betaFull;
+      Budget budgetBoot = {start, timeBudget, iteBudget, 0, mainThread, &cancel};
+      double phiBoot = phi0;
+      int iteTBoot = 0;
+      statusBoot(b) = ilamm(X, rows, colMean, colScale, YBoot, beta, lambda, penalty, "Huber",
+                            tau, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, "LAMM", -1,
+                            false, rngBoot, budgetBoot, phiBoot, iteTBoot);
+      betaBoot.col(b) = unscaleBeta(beta, colMean, colScale);
+    } catch (...) {
+      failed.store(true);
+      cancel.store(true);
+    }
+  }
+  if (failed.load()) {
+    Rcpp::stop("bootNcvxHuberReg: a fit on the samples failed");
+  }
+  arma::vec freq = arma::vec(d + 1);
+  freq.fill(arma::datum::nan);
+  arma::mat quantiles = arma::mat(d + 1, probSeq.size());
+  quantiles.fill(arma::datum::nan);
+  arma::uvec done = arma::find(statusBoot <= 2);
+  if (!done.is_empty()) {
+    arma::mat betaDone = betaBoot.cols(done);
+    freq = arma::mean(arma::conv_to<arma::mat>::from(betaDone != 0), 1);
+    for (int j = 0; j <= d; j++) {
+      arma::vec coef = arma::sort(betaDone.row(j).t());
+      for (int k = 0; k < (int)probSeq.size(); k++) {
+        quantiles(j, k) = quantileSorted(coef, probSeq(k));
+      }
+    }
+  }
+  betaFull = unscaleBeta(betaFull, colMean, colScale);
+  return Rcpp::List::create(Rcpp::Named("beta") = betaFull, Rcpp::Named("freq") = freq,
+                            Rcpp::Named("quantiles") = quantiles, Rcpp::Named("probs") = probSeq,
+                            Rcpp::Named("penalty") = penalty, Rcpp::Named("lambda") = lambda,
+                            Rcpp::Named("tau") = tau, Rcpp::Named("nboot") = nboot,
+                            Rcpp::Named("nsample") = m, Rcpp::Named("status") = status,
+                            Rcpp::Named("statusBoot") = statusBoot);
 }
 
+// A cross validation or fit job running on its own thread. The main thread only reads the atomics
+// until done is set, then the results, and deleting the job cancels and joins the thread.
+struct AsyncJob {
+  arma::mat X;
+  arma::vec Y;
+  arma::vec lambdaSeq;
+  arma::vec tauSeq;
+  int nlambda;
+  int ntau;
+  std::string lossType;
+  std::string penalty;
+  double phi0;
+  double gamma;
+  double epsilon_c;
+  double epsilon_t;
+  int iteMax;
+  int nfolds;
+  bool intercept;
+  bool standardize;
+  double timeBudget;
+  int iteBudget;
+  std::chrono::steady_clock::time_point start;
+  int total;
+  std::atomic<int> progress;
+  std::atomic<bool> cancel;
+  std::atomic<bool> abort;
+  std::atomic<bool> done;
+  arma::vec beta;
+  arma::mat mse;
+  double lambdaMin;
+  double tauMin;
+  int iteTotal;
+  int status;
+  // The single fits of ncvxRegAsync and ncvxHuberRegAsync, beta is also their initial value
+  bool fit;
+  double lambda;
+  double tau;
+  std::string solver;
+  int batchSize;
+  bool warm;
+  std::mt19937 rng;
+  double phi;
+  int iteT;
+  std::string error;
+  std::thread worker;
+  ~AsyncJob() {
+    cancel.store(true);
+    abort.store(true);
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+};
+
+// The body of the thread of a job. A cross validation job is the k-fold cross validation of
+// cvNcvxReg and cvNcvxHuberReg without the cache, where cancel stops the grid search and abort the
+// final fit. A fit job is the fit of ncvxReg or ncvxHuberReg, which cancel stops.
+void runAsyncJob(AsyncJob* job) {
+  try {
+    if (job->fit) {
+      Budget budget = {job->start, job->timeBudget, job->iteBudget, 0, false, &job->cancel};
+      job->status = fitCore(job->X, job->Y, job->lambda, job->tau, job->penalty, job->lossType,
+                            job->phi0, job->gamma, job->epsilon_c, job->epsilon_t, job->iteMax,
+                            job->intercept, job->standardize, job->solver, job->batchSize,
+                            job->warm, job->rng, budget, job->beta, job->phi, job->iteT);
+      job->iteTotal = budget.iteTotal;
+      job->progress.store(1);
+    } else {
+      std::vector<CacheEntry> cache;
+      arma::uword idxLambda = 0;
+      arma::uword idxTau = 0;
+      job->status = cvCore(job->X, job->Y, job->lambdaSeq, job->nlambda, job->tauSeq, job->ntau,
+                           job->lossType, job->penalty, job->phi0, job->gamma, job->epsilon_c,
+                           job->epsilon_t, job->iteMax, job->nfolds, job->intercept,
+                           job->standardize, "kfold", cache, "", job->start, job->timeBudget,
+                           job->iteBudget, false, &job->cancel, &job->abort, &job->progress,
+                           job->mse, job->beta, idxLambda, idxTau, job->iteTotal);
+      job->lambdaMin = job->lambdaSeq(idxLambda);
+      job->tauMin = job->tauSeq(idxTau);
+    }
+  } catch (std::exception& e) {
+    job->error = e.what();
+  } catch (...) {
+    job->error = "unknown error";
+  }
+  job->done.store(true);
+}
+
+// The tag of the external pointers of jobs, so that other external pointers are rejected
+SEXP asyncTag() {
+  return Rf_install("ILAMM_AsyncJob");
+}
+
+// Start the thread of a job and wrap it into an external pointer, whose finalizer deletes the job.
+// lSeq and nfolds only apply to cross validation jobs.
+SEXP launchAsync(AsyncJob* job, arma::mat X, const arma::vec& Y,
+                 Rcpp::Nullable<Rcpp::NumericVector> lSeq, const bool itcpIncluded) {
+  job->start = std::chrono::steady_clock::now();
+  if (!itcpIncluded) {
+    arma::mat XX = arma::ones(X.n_rows, X.n_cols + 1);
+    XX.cols(1, X.n_cols) = X;
+    X = XX;
+  }
+  job->X = X;
+  job->Y = Y;
+  int n = Y.size();
+  if (!job->fit && lSeq.isNotNull()) {
+    job->lambdaSeq = Rcpp::as<arma::vec>(lSeq);
+    job->nlambda = job->lambdaSeq.size();
+  }
+  if (!job->fit && (job->nfolds > 10 || job->nfolds > n)) {
+    job->nfolds = n < 10 ? n : 10;
+    std::cout << "Number of folds is too large, we'll set it to be: " << job->nfolds << std::endl;
+  }
+  job->total = job->fit ? 1 : job->nlambda * job->ntau;
+  job->progress.store(0);
+  job->cancel.store(false);
+  job->abort.store(false);
+  job->done.store(false);
+  job->iteTotal = 0;
+  job->status = 0;
+  Rcpp::XPtr<AsyncJob> ptr(job, true, asyncTag());
+  job->worker = std::thread(runAsyncJob, job);
+  return ptr;
+}
+
+//' The function starts k-fold cross validation for (high-dimensional) regularized regression with non-convex penalties on a background thread, and returns at once with a handle of the job.
+//'
+//' The job runs the same k-fold cross validation as \code{cvNcvxReg}, without \code{cacheDir}. It runs on a native thread outside of R, so the R session stays responsive, e.g. a Shiny or plumber service keeps serving requests while the model is tuned. Use \code{asyncStatus} to poll the job, \code{asyncCancel} to cancel it and \code{asyncResult} to get its result. The job is stopped if its handle is garbage collected.
+//'
+//' @title Background k-fold cross validation for non-convex regularized regression
+//' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, either low-dimensional data (\eqn{d \le n}) or high-dimensional data (\eqn{d > n}) are allowed.
+//' @param Y A continuous response vector with length \eqn{n}.
+//' @param lSeq Sequence of tuning parameter of regularized regression \eqn{\lambda}, see \code{cvNcvxReg}.
+//' @param nlambda Number of \eqn{\lambda} to generate the default sequence \code{lSeq}. It's not necessary if \code{lSeq} is specified. The default value is 30.
+//' @param penalty Type of non-convex penalties with default setting "SCAD", possible choices are: "Lasso", "SCAD" and "MCP".
+//' @param phi0 The initial value of the isotropic parameter \eqn{\phi} in I-LAMM algorithm. The defalut value is 0.001.
+//' @param gamma The inflation parameter in I-LAMM algorithm, in each iteration of I-LAMM, we will inflate \eqn{\phi} by \eqn{\gamma}. The defalut value is 1.5.
+//' @param epsilon_c The tolerance level for contraction stage, iteration of contraction will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_c}. The defalut value is 1e-4.
+//' @param epsilon_t The tolerance level for tightening stage, iteration of tightening will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_t}. The defalut value is 1e-4.
+//' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
+//' @param nfolds The number of folds to conduct cross validation, values that are greater than 10 are not recommended, and it'll be modified to 10 if the input is greater than 10. The default value is 3.
+//' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
+//' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting, see \code{ncvxReg}. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the whole job in seconds, see \code{cvNcvxReg}. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations of the grid search of the job, see \code{cvNcvxReg}. Non-positive values mean no limit. The default value is -1.
+//' @return A handle of the job, an external pointer to be passed to \code{asyncStatus}, \code{asyncCancel} and \code{asyncResult}.
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @seealso \code{\link{cvNcvxReg}}, \code{\link{asyncStatus}}, \code{\link{asyncResult}}
+//' @examples
+//' n = 50
+//' d = 100
+//' set.seed(2018)
+//' X = matrix(rnorm(n * d), n, d)
+//' beta = c(rep(2, 3), rep(0, d - 3))
+//' Y = X %*% beta + rnorm(n)
+//' job = cvNcvxRegAsync(X, Y)
+//' asyncStatus(job)
+//' fit = asyncResult(job, wait = TRUE)
+//' fit$lambdaMin
+//' @export
+// [[Rcpp::export]]
+SEXP cvNcvxRegAsync(arma::mat X, const arma::vec& Y,
+                    Rcpp::Nullable<Rcpp::NumericVector> lSeq = R_NilValue, int nlambda = 30,
+                    const std::string penalty = "SCAD", const double phi0 = 0.001,
+                    const double gamma = 1.5, const double epsilon_c = 0.0001,
+                    const double epsilon_t = 0.0001, const int iteMax = 500, int nfolds = 3,
+                    const bool intercept = false, const bool itcpIncluded = false,
+                    const bool standardize = false, const double timeBudget = -1,
+                    const int iteBudget = -1) {
+  checkData(X, Y);
+  AsyncJob* job = new AsyncJob();
+  job->fit = false;
+  job->nlambda = nlambda;
+  job->ntau = 1;
+  job->tauSeq = arma::ones(1);
+  job->lossType = "l2";
+  job->penalty = penalty;
+  job->phi0 = phi0;
+  job->gamma = gamma;
+  job->epsilon_c = epsilon_c;
+  job->epsilon_t = epsilon_t;
+  job->iteMax = iteMax;
+  job->nfolds = nfolds;
+  job->intercept = intercept;
+  job->standardize = standardize;
+  job->timeBudget = timeBudget;
+  job->iteBudget = iteBudget;
+  return launchAsync(job, X, Y, lSeq, itcpIncluded);
+}
+
+//' The function starts k-fold cross validation for (high-dimensional) Huber regularized regression with non-convex penalties on a background thread, and returns at once with a handle of the job.
+//'
+//' The job runs the same k-fold cross validation as \code{cvNcvxHuberReg}, without \code{cacheDir}. It runs on a native thread outside of R, so the R session stays responsive, e.g. a Shiny or plumber service keeps serving requests while the model is tuned. Use \code{asyncStatus} to poll the job, \code{asyncCancel} to cancel it and \code{asyncResult} to get its result. The job is stopped if its handle is garbage collected.
+//'
+//' @title Background k-fold cross validation for non-convex regularized Huber regression
+//' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, either low-dimensional data (\eqn{d \le n}) or high-dimensional data (\eqn{d > n}) are allowed.
+//' @param Y A continuous response vector with length \eqn{n}.
+//' @param lSeq Sequence of tuning parameter of regularized regression \eqn{\lambda}, see \code{cvNcvxHuberReg}.
+//' @param nlambda Number of \eqn{\lambda} to generate the default sequence \code{lSeq}. It's not necessary if \code{lSeq} is specified. The default value is 30.
+//' @param penalty Type of non-convex penalties with default setting "SCAD", possible choices are: "Lasso", "SCAD" and "MCP".
+//' @param tSeq Sequence of robustness parameter of Huber loss \eqn{\tau}, see \code{cvNcvxHuberReg}. The default sequence is the one of \code{cvNcvxHuberReg}.
+//' @param ntau Number of \eqn{\tau} to generate the default sequence \code{tSeq}. It's not necessary if \code{tSeq} is specified. The default value is 5.
+//' @param phi0 The initial value of the isotropic parameter \eqn{\phi} in I-LAMM algorithm. The defalut value is 0.001.
+//' @param gamma The inflation parameter in I-LAMM algorithm, in each iteration of I-LAMM, we will inflate \eqn{\phi} by \eqn{\gamma}. The defalut value is 1.5.
+//' @param epsilon_c The tolerance level for contraction stage, iteration of contraction will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_c}. The defalut value is 1e-4.
+//' @param epsilon_t The tolerance level for tightening stage, iteration of tightening will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_t}. The defalut value is 1e-4.
+//' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
+//' @param nfolds The number of folds to conduct cross validation, values that are greater than 10 are not recommended, and it'll be modified to 10 if the input is greater than 10. The default value is 3.
+//' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
+//' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting, see \code{ncvxHuberReg}. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the whole job in seconds, see \code{cvNcvxHuberReg}. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations of the grid search of the job, see \code{cvNcvxHuberReg}. Non-positive values mean no limit. The default value is -1.
+//' @return A handle of the job, an external pointer to be passed to \code{asyncStatus}, \code{asyncCancel} and \code{asyncResult}.
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @seealso \code{\link{cvNcvxHuberReg}}, \code{\link{asyncStatus}}, \code{\link{asyncResult}}
+//' @examples
+//' n = 50
+//' d = 100
+//' set.seed(2018)
+//' X = matrix(rnorm(n * d), n, d)
+//' beta = c(rep(2, 3), rep(0, d - 3))
+//' Y = X %*% beta + rlnorm(n, 0, 1.2) - exp(1.2^2 / 2)
+//' job = cvNcvxHuberRegAsync(X, Y)
+//' # The R session is free while the job runs
+//' while (!asyncStatus(job)$done) {
+//'   Sys.sleep(0.1)
+//' }
+//' fit = asyncResult(job)
+//' fit$lambdaMin
+//' fit$tauMin
+//' @export
+// [[Rcpp::export]]
+SEXP cvNcvxHuberRegAsync(arma::mat X, const arma::vec& Y,
+                         Rcpp::Nullable<Rcpp::NumericVector> lSeq = R_NilValue,
+                         int nlambda = 30, const std::string penalty = "SCAD",
+                         Rcpp::Nullable<Rcpp::NumericVector> tSeq = R_NilValue, int ntau = 5,
+                         const double phi0 = 0.001, const double gamma = 1.5,
+                         const double epsilon_c = 0.0001, const double epsilon_t = 0.0001,
+                         const int iteMax = 500, int nfolds = 3, const bool intercept = false,
+                         const bool itcpIncluded = false, const bool standardize = false,
+                         const double timeBudget = -1, const int iteBudget = -1) {
+  checkData(X, Y);
+  AsyncJob* job = new AsyncJob();
+  job->fit = false;
+  job->nlambda = nlambda;
+  job->ntau = ntau;
+  if (tSeq.isNotNull()) {
+    job->tauSeq = Rcpp::as<arma::vec>(tSeq);
+    job->ntau = job->tauSeq.size();
+  }
+  job->lossType = "Huber";
+  job->penalty = penalty;
+  job->phi0 = phi0;
+  job->gamma = gamma;
+  job->epsilon_c = epsilon_c;
+  job->epsilon_t = epsilon_t;
+  job->iteMax = iteMax;
+  job->nfolds = nfolds;
+  job->intercept = intercept;
+  job->standardize = standardize;
+  job->timeBudget = timeBudget;
+  job->iteBudget = iteBudget;
+  return launchAsync(job, X, Y, lSeq, itcpIncluded);
+}
+
+//' The function starts a fit of (high-dimensional) regularized regression with non-convex penalties on a background thread, and returns at once with a handle of the job.
+//'
+//' The job runs the same fit as \code{ncvxReg}. It runs on a native thread outside of R, so the R session stays responsive. Use \code{asyncStatus} to poll the job, \code{asyncCancel} to cancel it and \code{asyncResult} to get its result. The job is stopped if its handle is garbage collected.
+//'
+//' @title Background fit of non-convex regularized regression
+//' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, either low-dimensional data (\eqn{d \le n}) or high-dimensional data (\eqn{d > n}) are allowed.
+//' @param Y A continuous response vector with length \eqn{n}.
+//' @param lambda Tuning parameter of regularized regression, see \code{ncvxReg}. The default value -1 means the default of \code{ncvxReg}.
+//' @param penalty Type of non-convex penalties with default setting "SCAD", possible choices are: "Lasso", "SCAD" and "MCP".
+//' @param phi0 The initial value of the isotropic parameter \eqn{\phi} in I-LAMM algorithm. The defalut value is 0.001.
+//' @param gamma The inflation parameter in I-LAMM algorithm, in each iteration of I-LAMM, we will inflate \eqn{\phi} by \eqn{\gamma}. The defalut value is 1.5.
+//' @param epsilon_c The tolerance level for contraction stage, iteration of contraction will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_c}. The defalut value is 1e-4.
+//' @param epsilon_t The tolerance level for tightening stage, iteration of tightening will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_t}. The defalut value is 1e-4.
+//' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
+//' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
+//' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting, see \code{ncvxReg}. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the fit in seconds, see \code{ncvxReg}. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations over all stages of the fit, see \code{ncvxReg}. Non-positive values mean no limit. The default value is -1.
+//' @param betaInit Optional initial value of \eqn{\beta} on the original scale to warm start the I-LAMM iterations, see \code{ncvxReg}.
+//' @param solver The solver of each I-LAMM iteration, possible choices are "LAMM" (default), "SVRG" and "Newton", see \code{ncvxReg}. The random mini-batches of "SVRG" are seeded from R's random number generator when the job starts.
+//' @param batchSize The mini-batch size of the "SVRG" solver, see \code{ncvxReg}. The default value is -1.
+//' @return A handle of the job, an external pointer to be passed to \code{asyncStatus}, \code{asyncCancel} and \code{asyncResult}.
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @seealso \code{\link{ncvxReg}}, \code{\link{asyncStatus}}, \code{\link{asyncResult}}
+//' @examples
+//' n = 50
+//' d = 100
+//' set.seed(2018)
+//' X = matrix(rnorm(n * d), n, d)
+//' beta = c(rep(2, 3), rep(0, d - 3))
+//' Y = X %*% beta + rnorm(n)
+//' job = ncvxRegAsync(X, Y)
+//' fit = asyncResult(job, wait = TRUE)
+//' fit$beta[1:5]
+//' @export
+// [[Rcpp::export]]
+SEXP ncvxRegAsync(arma::mat X, const arma::vec& Y, const double lambda = -1,
+                  const std::string penalty = "SCAD", const double phi0 = 0.001,
+                  const double gamma = 1.5, const double epsilon_c = 0.0001,
+                  const double epsilon_t = 0.0001, const int iteMax = 500,
+                  const bool intercept = false, const bool itcpIncluded = false,
+                  const bool standardize = false, const double timeBudget = -1,
+                  const int iteBudget = -1,
+                  Rcpp::Nullable<Rcpp::NumericVector> betaInit = R_NilValue,
+                  const std::string solver = "LAMM", const int batchSize = -1) {
+  checkData(X, Y);
+  checkSolver(solver, batchSize);
+  AsyncJob* job = new AsyncJob();
+  job->fit = true;
+  job->lambda = lambda;
+  job->tau = 1;
+  job->lossType = "l2";
+  job->penalty = penalty;
+  job->phi0 = phi0;
+  job->gamma = gamma;
+  job->epsilon_c = epsilon_c;
+  job->epsilon_t = epsilon_t;
+  job->iteMax = iteMax;
+  job->intercept = intercept;
+  job->standardize = standardize;
+  job->timeBudget = timeBudget;
+  job->iteBudget = iteBudget;
+  job->warm = betaInit.isNotNull();
+  if (job->warm) {
+    job->beta = Rcpp::as<arma::vec>(betaInit);
+  }
+  job->solver = solver;
+  job->batchSize = batchSize;
+  if (solver == "SVRG") {
+    job->rng.seed((unsigned int)(R::unif_rand() * 4294967295.0));
+  }
+  job->phi = phi0;
+  job->iteT = 0;
+  return launchAsync(job, X, Y, R_NilValue, itcpIncluded);
+}
+
+//' The function starts a fit of (high-dimensional) Huber regularized regression with non-convex penalties on a background thread, and returns at once with a handle of the job.
+//'
+//' The job runs the same fit as \code{ncvxHuberReg}, including the Lasso pilot fit for the default \eqn{\tau}. It runs on a native thread outside of R, so the R session stays responsive. Use \code{asyncStatus} to poll the job, \code{asyncCancel} to cancel it and \code{asyncResult} to get its result. The job is stopped if its handle is garbage collected.
+//'
+//' @title Background fit of non-convex regularized Huber regression
+//' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, either low-dimensional data (\eqn{d \le n}) or high-dimensional data (\eqn{d > n}) are allowed.
+//' @param Y A continuous response vector with length \eqn{n}.
+//' @param lambda Tuning parameter of regularized regression, see \code{ncvxHuberReg}. The default value -1 means the default of \code{ncvxHuberReg}.
+//' @param penalty Type of non-convex penalties with default setting "SCAD", possible choices are: "Lasso", "SCAD" and "MCP".
+//' @param tau Robustness parameter of Huber loss function, see \code{ncvxHuberReg}. The default value -1 means the default of \code{ncvxHuberReg}.
+//' @param phi0 The initial value of the isotropic parameter \eqn{\phi} in I-LAMM algorithm. The defalut value is 0.001.
+//' @param gamma The inflation parameter in I-LAMM algorithm, in each iteration of I-LAMM, we will inflate \eqn{\phi} by \eqn{\gamma}. The defalut value is 1.5.
+//' @param epsilon_c The tolerance level for contraction stage, iteration of contraction will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_c}. The defalut value is 1e-4.
+//' @param epsilon_t The tolerance level for tightening stage, iteration of tightening will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_t}. The defalut value is 1e-4.
+//' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
+//' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
+//' @param itcpIncluded Boolean value indicating whether a column of 1's has been included in the design matrix \eqn{X}. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the columns of \eqn{X} should be standardized before fitting, see \code{ncvxHuberReg}. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the fit in seconds, see \code{ncvxHuberReg}. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations over all stages of the fit, see \code{ncvxHuberReg}. Non-positive values mean no limit. The default value is -1.
+//' @param betaInit Optional initial value of \eqn{\beta} on the original scale to warm start the I-LAMM iterations, see \code{ncvxHuberReg}.
+//' @param solver The solver of each I-LAMM iteration, possible choices are "LAMM" (default), "SVRG" and "Newton", see \code{ncvxHuberReg}. The random mini-batches of "SVRG" are seeded from R's random number generator when the job starts.
+//' @param batchSize The mini-batch size of the "SVRG" solver, see \code{ncvxHuberReg}. The default value is -1.
+//' @return A handle of the job, an external pointer to be passed to \code{asyncStatus}, \code{asyncCancel} and \code{asyncResult}.
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @seealso \code{\link{ncvxHuberReg}}, \code{\link{asyncStatus}}, \code{\link{asyncResult}}
+//' @examples
+//' n = 50
+//' d = 100
+//' set.seed(2018)
+//' X = matrix(rnorm(n * d), n, d)
+//' beta = c(rep(2, 3), rep(0, d - 3))
+//' Y = X %*% beta + rlnorm(n, 0, 1.2) - exp(1.2^2 / 2)
+//' job = ncvxHuberRegAsync(X, Y)
+//' # The R session is free while the job runs
+//' while (!asyncStatus(job)$done) {
+//'   Sys.sleep(0.1)
+//' }
+//' fit = asyncResult(job)
+//' fit$tau
+//' @export
+// [[Rcpp::export]]
+SEXP ncvxHuberRegAsync(arma::mat X, const arma::vec& Y, const double lambda = -1,
+                       const std::string penalty = "SCAD", const double tau = -1,
+                       const double phi0 = 0.001, const double gamma = 1.5,
+                       const double epsilon_c = 0.0001, const double epsilon_t = 0.0001,
+                       const int iteMax = 500, const bool intercept = false,
+                       const bool itcpIncluded = false, const bool standardize = false,
+                       const double timeBudget = -1, const int iteBudget = -1,
+                       Rcpp::Nullable<Rcpp::NumericVector> betaInit = R_NilValue,
+                       const std::string solver = "LAMM", const int batchSize = -1) {
+  checkData(X, Y);
+  checkSolver(solver, batchSize);
+  AsyncJob* job = new AsyncJob();
+  job->fit = true;
+  job->lambda = lambda;
+  job->tau = tau;
+  job->lossType = "Huber";
+  job->penalty = penalty;
+  job->phi0 = phi0;
+  job->gamma = gamma;
+  job->epsilon_c = epsilon_c;
+  job->epsilon_t = epsilon_t;
+  job->iteMax = iteMax;
+  job->intercept = intercept;
+  job->standardize = standardize;
+  job->timeBudget = timeBudget;
+  job->iteBudget = iteBudget;
+  job->warm = betaInit.isNotNull();
+  if (job->warm) {
+    job->beta = Rcpp::as<arma::vec>(betaInit);
+  }
+  job->solver = solver;
+  job->batchSize = batchSize;
+  if (solver == "SVRG") {
+    job->rng.seed((unsigned int)(R::unif_rand() * 4294967295.0));
+  }
+  job->phi = phi0;
+  job->iteT = 0;
+  return launchAsync(job, X, Y, R_NilValue, itcpIncluded);
+}
+
+// The job of a handle. Anything but a live handle of a job of the package is an error, as a
+// foreign external pointer would be read as a job.
+AsyncJob* getAsyncJob(SEXP job) {
+  if (TYPEOF(job) != EXTPTRSXP || R_ExternalPtrTag(job) != asyncTag()) {
+    Rcpp::stop("job must be a handle returned by one of the background job functions");
+  }
+  AsyncJob* ptr = (AsyncJob*)R_ExternalPtrAddr(job);
+  if (ptr == NULL) {
+    Rcpp::stop("the handle of the job is no longer valid, e.g. after it was saved and reloaded");
+  }
+  return ptr;
+}
+
+//' The function polls a background job started by \code{cvNcvxRegAsync}, \code{cvNcvxHuberRegAsync}, \code{ncvxRegAsync} or \code{ncvxHuberRegAsync} without blocking. An error is raised if \code{job} isn't the handle of such a job.
+//'
+//' @title Status of a background job
+//' @param job The handle of the job.
+//' @return A list including the following terms will be returned:
+//' \itemize{
+//' \item \code{done} Boolean value indicating whether the job has finished, either completed, stopped or failed.
+//' \item \code{progress} The number of grid cells whose cross validation error has been computed, or 1 once a fit job has finished.
+//' \item \code{total} The number of grid cells of the job, or 1 for a fit job.
+//' \item \code{cancelled} Boolean value indicating whether the job has been cancelled.
+//' }
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @seealso \code{\link{asyncResult}}, \code{\link{asyncCancel}}
+//' @export
+// [[Rcpp::export]]
+Rcpp::List asyncStatus(SEXP job) {
+  AsyncJob* ptr = getAsyncJob(job);
+  return Rcpp::List::create(Rcpp::Named("done") = ptr->done.load(),
+                            Rcpp::Named("progress") = ptr->progress.load(),
+                            Rcpp::Named("total") = ptr->total,
+                            Rcpp::Named("cancelled") = ptr->cancel.load());
+}
+
+//' The function cancels a background job started by \code{cvNcvxRegAsync}, \code{cvNcvxHuberRegAsync}, \code{ncvxRegAsync} or \code{ncvxHuberRegAsync}. The grid search of a cross validation stops at its next check, within one I-LAMM iteration, and the result is then the one of a cross validation interrupted by the user: the values of \code{mse} that were not evaluated are \code{NA}, and the model is still fitted on the full data at the best grid value evaluated so far. A fit stops at its next check as well, and its result is the last iterate with \code{status = 4}.
+//'
+//' @title Cancel a background job
+//' @param job The handle of the job.
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @seealso \code{\link{asyncStatus}}, \code{\link{asyncResult}}
+//' @export
+// [[Rcpp::export]]
+void asyncCancel(SEXP job) {
+  AsyncJob* ptr = getAsyncJob(job);
+  ptr->cancel.store(true);
+}
+
+//' The function retrieves the result of a background job started by \code{cvNcvxRegAsync}, \code{cvNcvxHuberRegAsync}, \code{ncvxRegAsync} or \code{ncvxHuberRegAsync}.
+//'
+//' @title Result of a background job
+//' @param job The handle of the job.
+//' @param wait Boolean value indicating whether to wait for the job to finish. The waiting can be interrupted by the user, and the job keeps running. The default setting is \code{FALSE}.
+//' @return \code{NULL} if the job hasn't finished, otherwise a list with the same terms as the one of \code{cvNcvxReg}, \code{cvNcvxHuberReg}, \code{ncvxReg} or \code{ncvxHuberReg} respectively. An error is raised if the job failed.
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @seealso \code{\link{asyncStatus}}, \code{\link{asyncCancel}}
+//' @export
+// [[Rcpp::export]]
+Rcpp::RObject asyncResult(SEXP job, const bool wait = false) {
+  AsyncJob* ptr = getAsyncJob(job);
+  while (wait && !ptr->done.load()) {
+    Rcpp::checkUserInterrupt();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (!ptr->done.load()) {
+    return R_NilValue;
+  }
+  if (ptr->worker.joinable()) {
+    ptr->worker.join();
+  }
+  if (ptr->error != "") {
+    Rcpp::stop("the background job failed: " + ptr->error);
+  }
+  if (ptr->fit && ptr->lossType == "l2") {
+    return Rcpp::List::create(Rcpp::Named("beta") = ptr->beta, Rcpp::Named("phi") = ptr->phi,
+                              Rcpp::Named("penalty") = ptr->penalty,
+                              Rcpp::Named("lambda") = ptr->lambda,
+                              Rcpp::Named("IteTightening") = ptr->iteT,
+                              Rcpp::Named("iteTotal") = ptr->iteTotal,
+                              Rcpp::Named("status") = ptr->status);
+  }
+  if (ptr->fit) {
+    return Rcpp::List::create(Rcpp::Named("beta") = ptr->beta, Rcpp::Named("phi") = ptr->phi,
+                              Rcpp::Named("penalty") = ptr->penalty,
+                              Rcpp::Named("lambda") = ptr->lambda, Rcpp::Named("tau") = ptr->tau,
+                              Rcpp::Named("IteTightening") = ptr->iteT,
+                              Rcpp::Named("iteTotal") = ptr->iteTotal,
+                              Rcpp::Named("status") = ptr->status);
+  }
+  if (ptr->lossType == "l2") {
+    return Rcpp::List::create(Rcpp::Named("beta") = ptr->beta,
+                              Rcpp::Named("penalty") = ptr->penalty,
+                              Rcpp::Named("lambdaSeq") = ptr->lambdaSeq,
+                              Rcpp::Named("mse") = arma::vec(ptr->mse.col(0)),
+                              Rcpp::Named("lambdaMin") = ptr->lambdaMin,
+                              Rcpp::Named("nfolds") = ptr->nfolds,
+                              Rcpp::Named("iteTotal") = ptr->iteTotal,
+                              Rcpp::Named("status") = ptr->status);
+  }
+  return Rcpp::List::create(Rcpp::Named("beta") = ptr->beta, Rcpp::Named("penalty") = ptr->penalty,
+                            Rcpp::Named("lambdaSeq") = ptr->lambdaSeq,
+                            Rcpp::Named("tauSeq") = ptr->tauSeq, Rcpp::Named("mse") = ptr->mse,
+                            Rcpp::Named("lambdaMin") = ptr->lambdaMin,
+                            Rcpp::Named("tauMin") = ptr->tauMin,
+                            Rcpp::Named("nfolds") = ptr->nfolds,
+                            Rcpp::Named("iteTotal") = ptr->iteTotal,
+                            Rcpp::Named("status") = ptr->status);
+}
+
+// Robust marginal utilities of the columns of X (without the intercept column) in one streaming
+// pass, with the columns split over the kernel threads: the absolute correlation between each
+// column and psi(res), where psi is Huber's psi with tau = sigma * sqrt(n / log(n * d)) and sigma
+// the MAD of the residuals. The excluded columns get -1.
+arma::vec cmptUtility(const arma::mat& X, const arma::vec& res, const arma::uvec& excluded) {
+  int n = X.n_rows;
+  int d = X.n_cols;
+  double sigmaHat = arma::median(arma::abs(res - arma::median(res))) / 0.6745;
+  arma::vec psi = res;
+  if (sigmaHat > 0) {
+    double tau = sigmaHat * std::sqrt(n / std::log((double)n * d));
+    psi = arma::clamp(res, -tau, tau);
+  }
+  psi -= arma::mean(psi);
+  double psiNorm = arma::norm(psi, 2);
+  arma::vec rst = arma::vec(d);
+  int nt = cmptThreads(d);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+  for (int j = 0; j < d; j++) {
+    if (excluded(j)) {
+      rst(j) = -1;
+      continue;
+    }
+    const double* col = X.colptr(j);
+    double m = 0, s = 0, cov = 0;
+    for (int i = 0; i < n; i++) {
+      double delta = col[i] - m;
+      m += delta / (i + 1);
+      s += delta * (col[i] - m);
+      cov += col[i] * psi(i);
+    }
+    rst(j) = (s > 0 && psiNorm > 0) ? std::abs(cov) / (std::sqrt(s) * psiNorm) : 0;
+  }
+  return rst;
+}
+
+//' The function fits (ultra-high-dimensional) Huber regularized regression with non-convex penalties after (iterative) sure independence screening of the columns of \eqn{X}.
+//'
+//' The columns of \eqn{X} are ranked by their robust marginal utility, the absolute correlation with \eqn{\psi(R)}, where \eqn{\psi} is Huber's \eqn{\psi} function, and \eqn{R} is \eqn{Y} minus its median. The utilities are computed in a single pass over the columns of \eqn{X}, which is neither copied nor augmented, and the columns are split over the threads set by \code{setThreads}. Then \code{ncvxHuberReg} is fitted on the \code{k} top ranked columns. With \code{niter} > 1, the screening is iterated as in iterative sure independence screening: the columns with nonzero coefficients are kept, the remaining columns are ranked against the residual of the fit to fill up \code{k} columns, and the model is fitted again, until \code{niter} iterations are done or the set of columns doesn't change. The returned coefficients have the full length of \eqn{X}.
+//'
+//' @title Non-convex regularized Huber regression with sure independence screening
+//' @param X An \eqn{n} by \eqn{d} design matrix with each row being a sample and each column being a variable, typically with \eqn{d} much larger than \eqn{n}. It must not include a column of 1's.
+//' @param Y A continuous response vector with length \eqn{n}.
+//' @param k The number of columns kept by the screening. The default value -1 means \eqn{n / log(n)} rounded down. If it's at least \eqn{d}, no screening takes place.
+//' @param niter The maximal number of screening iterations. The default value 1 means sure independence screening without iteration.
+//' @param lambda Tuning parameter of regularized regression, its specified value should be positive. The default value is the one of \code{ncvxHuberReg} on the screened columns.
+//' @param penalty Type of non-convex penalties with default setting "SCAD", possible choices are: "Lasso", "SCAD" and "MCP".
+//' @param tau Robustness parameter of Huber loss function, its specified value should be positive. The default value is the one of \code{ncvxHuberReg} on the screened columns.
+//' @param phi0 The initial value of the isotropic parameter \eqn{\phi} in I-LAMM algorithm. The defalut value is 0.001.
+//' @param gamma The inflation parameter in I-LAMM algorithm, in each iteration of I-LAMM, we will inflate \eqn{\phi} by \eqn{\gamma}. The defalut value is 1.5.
+//' @param epsilon_c The tolerance level for contraction stage, iteration of contraction will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_c}. The defalut value is 1e-4.
+//' @param epsilon_t The tolerance level for tightening stage, iteration of tightening will stop when \eqn{||\beta_new - \beta_old||_2 / \sqrt(d + 1) < \epsilon_t}. The defalut value is 1e-4.
+//' @param iteMax The maximal number of iteration in either contraction or tightening stage, if this number is reached, the convergence of I-LAMM is failed. The defalut value is 500.
+//' @param intercept Boolean value indicating whether an intercept term should be included into the model. The default setting is \code{FALSE}.
+//' @param standardize Boolean value indicating whether the screened columns should be standardized before fitting, see \code{ncvxHuberReg}. The default setting is \code{FALSE}.
+//' @param timeBudget The wall-clock time budget of the whole run in seconds, see \code{ncvxHuberReg}. Non-positive values mean no limit. The default value is -1.
+//' @param iteBudget The maximal total number of LAMM iterations over all the fits, see \code{ncvxHuberReg}. Non-positive values mean no limit. The default value is -1.
+//' @return A list including the following terms will be returned:
+//' \itemize{
+//' \item \code{beta} The estimated \eqn{\beta}, a vector with length d + 1, with the first one being the value of intercept (0 if \code{intercept = FALSE}), and 0 for the columns that were screened out.
+//' \item \code{screened} The indices of the columns of \eqn{X} that were kept by the last screening.
+//' \item \code{penalty} The type of penalty.
+//' \item \code{lambda} The value of \eqn{\lambda} of the last fit.
+//' \item \code{tau} The value of \eqn{\tau} of the last fit.
+//' \item \code{iteSIS} The number of screening iterations.
+//' \item \code{status} The status of the last fit, see \code{ncvxHuberReg}.
+//' }
+//' @author Xiaoou Pan, Qiang Sun, Wen-Xin Zhou
+//' @references Fan, J. and Lv, J. (2008). Sure independence screening for ultrahigh dimensional feature space. J. R. Stat. Soc. Ser. B. Stat. Methodol. 70 849–911.
+//' @seealso \code{\link{ncvxHuberReg}}
+//' @examples
+//' n = 50
+//' d = 2000
+//' set.seed(2018)
+//' X = matrix(rnorm(n * d), n, d)
+//' beta = c(rep(2, 3), rep(0, d - 3))
+//' Y = X %*% beta + rlnorm(n, 0, 1.2) - exp(1.2^2 / 2)
+//' # Screen to n / log(n) columns, then fit Huber-SCAD
+//' fit = sisNcvxHuberReg(X, Y)
+//' which(fit$beta[-1] != 0)
+//' # Iterative screening with Huber-MCP
+//' fit = sisNcvxHuberReg(X, Y, niter = 3, penalty = "MCP")
+//' which(fit$beta[-1] != 0)
+//' @export
+// [[Rcpp::export]]
+Rcpp::List sisNcvxHuberReg(const arma::mat& X, const arma::vec& Y, int k = -1,
+                           const int niter = 1, double lambda = -1,
+                           std::string penalty = "SCAD", double tau = -1,
+                           const double phi0 = 0.001, const double gamma = 1.5,
+                           const double epsilon_c = 0.0001, const double epsilon_t = 0.0001,
+                           const int iteMax = 500, const bool intercept = false,
+                           const bool standardize = false, const double timeBudget = -1,
+                           const int iteBudget = -1) {
+  checkData(X, Y);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  int n = Y.size();
+  int d = X.n_cols;
+  if (k <= 0) {
+    k = (int)(n / std::log((double)n));
+  }
+  k = std::min(std::max(k, 1), d);
+  arma::vec res = Y - arma::median(Y);
+  arma::uvec screened = arma::uvec();
+  arma::uvec active = arma::uvec();
+  arma::vec betaA = arma::zeros(1);
+  double lambdaA = lambda;
+  double tauA = tau;
+  std::mt19937 rng;
+  Budget budget = {start, timeBudget, iteBudget, 0, true, NULL};
+  int status = 0;
+  int iteSIS = 0;
+  while (iteSIS < niter && status <= 1) {
+    // Keep the active columns and fill up k columns by the utilities against the residual
+    arma::uvec excluded = arma::zeros<arma::uvec>(d);
+    excluded.elem(active).ones();
+    arma::vec utility = cmptUtility(X, res, excluded);
+    arma::uvec top = arma::sort_index(utility, "descend");
+    arma::uvec candidate = arma::sort(arma::join_cols(active, top.head(k - active.size())));
+    if (iteSIS > 0 && candidate.size() == screened.size() && arma::all(candidate == screened)) {
+      break;
+    }
+    iteSIS++;
+    screened = candidate;
+    int s = screened.size();
+    arma::mat XA = arma::ones(n, s + 1);
+    for (int t = 0; t < s; t++) {
+      XA.col(t + 1) = X.col(screened(t));
+    }
+    arma::vec colMean = arma::zeros(s + 1);
+    arma::vec colScale = arma::ones(s + 1);
+    if (standardize) {
+      cmptColScale(XA, arma::uvec(), colMean, colScale, intercept);
+    }
+    lambdaA = lambda > 0 ? lambda : defaultLambda(XA, arma::uvec(), colMean, colScale, Y);
+    if (tau <= 0) {
+      status = defaultTau(XA, colMean, colScale, Y, lambdaA, phi0, gamma, epsilon_c, epsilon_t,
+                          iteMax, intercept, "LAMM", -1, rng, budget, tauA);
+    }
+    betaA = arma::zeros(s + 1);
+    double phi = phi0;
+    int iteT = 0;
+    if (status <= 2) {
+      status = ilamm(XA, arma::uvec(), colMean, colScale, Y, betaA, lambdaA, penalty, "Huber",
+                     tauA, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, "LAMM", -1,
+                     false, rng, budget, phi, iteT);
+    }
+    betaA = unscaleBeta(betaA, colMean, colScale);
+    res = Y - XA * betaA;
+    active = screened.elem(arma::find(betaA.tail(s)));
+  }
+  arma::vec beta = arma::zeros(d + 1);
+  beta(0) = betaA(0);
+  beta.elem(screened + 1) = betaA.tail(screened.size());
+  return Rcpp::List::create(Rcpp::Named("beta") = beta, Rcpp::Named("screened") = screened + 1,
+                            Rcpp::Named("penalty") = penalty, Rcpp::Named("lambda") = lambdaA,
+                            Rcpp::Named("tau") = tauA, Rcpp::Named("iteSIS") = iteSIS,
+                            Rcpp::Named("status") = status);
+}
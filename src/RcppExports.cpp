@@ -42,6 +42,43 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// setThreads
+int setThreads(int nthreads);
+RcppExport SEXP _ILAMM_setThreads(SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(setThreads(nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// unscaleBeta
+arma::vec unscaleBeta(const arma::vec& beta, const arma::vec& colMean, const arma::vec& colScale);
+RcppExport SEXP _ILAMM_unscaleBeta(SEXP betaSEXP, SEXP colMeanSEXP, SEXP colScaleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type beta(betaSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type colMean(colMeanSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type colScale(colScaleSEXP);
+    rcpp_result_gen = Rcpp::wrap(unscaleBeta(beta, colMean, colScale));
+    return rcpp_result_gen;
+END_RCPP
+}
+// scaleBeta
+arma::vec scaleBeta(const arma::vec& beta, const arma::vec& colMean, const arma::vec& colScale);
+RcppExport SEXP _ILAMM_scaleBeta(SEXP betaSEXP, SEXP colMeanSEXP, SEXP colScaleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::vec& >::type beta(betaSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type colMean(colMeanSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type colScale(colScaleSEXP);
+    rcpp_result_gen = Rcpp::wrap(scaleBeta(beta, colMean, colScale));
+    return rcpp_result_gen;
+END_RCPP
+}
 // loss
 double loss(const arma::vec& Y, const arma::vec& Ynew, const std::string lossType, const double tau);
 RcppExport SEXP _ILAMM_loss(SEXP YSEXP, SEXP YnewSEXP, SEXP lossTypeSEXP, SEXP tauSEXP) {
@@ -143,8 +180,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // ncvxReg
-Rcpp::List ncvxReg(arma::mat X, const arma::vec& Y, double lambda, std::string penalty, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool itcpIncluded);
-RcppExport SEXP _ILAMM_ncvxReg(SEXP XSEXP, SEXP YSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP) {
+Rcpp::List ncvxReg(arma::mat X, const arma::vec& Y, double lambda, std::string penalty, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget, Rcpp::Nullable<Rcpp::NumericVector> betaInit, const std::string solver, const int batchSize);
+RcppExport SEXP _ILAMM_ncvxReg(SEXP XSEXP, SEXP YSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP, SEXP betaInitSEXP, SEXP solverSEXP, SEXP batchSizeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -159,13 +196,19 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
     Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
     Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
-    rcpp_result_gen = Rcpp::wrap(ncvxReg(X, Y, lambda, penalty, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, itcpIncluded));
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type betaInit(betaInitSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type solver(solverSEXP);
+    Rcpp::traits::input_parameter< const int >::type batchSize(batchSizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ncvxReg(X, Y, lambda, penalty, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, itcpIncluded, standardize, timeBudget, iteBudget, betaInit, solver, batchSize));
     return rcpp_result_gen;
 END_RCPP
 }
 // ncvxHuberReg
-Rcpp::List ncvxHuberReg(arma::mat X, const arma::vec& Y, double lambda, std::string penalty, double tau, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool itcpIncluded);
-RcppExport SEXP _ILAMM_ncvxHuberReg(SEXP XSEXP, SEXP YSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP tauSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP) {
+Rcpp::List ncvxHuberReg(arma::mat X, const arma::vec& Y, double lambda, std::string penalty, double tau, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget, Rcpp::Nullable<Rcpp::NumericVector> betaInit, const std::string solver, const int batchSize);
+RcppExport SEXP _ILAMM_ncvxHuberReg(SEXP XSEXP, SEXP YSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP tauSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP, SEXP betaInitSEXP, SEXP solverSEXP, SEXP batchSizeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -181,7 +224,13 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
     Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
     Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
-    rcpp_result_gen = Rcpp::wrap(ncvxHuberReg(X, Y, lambda, penalty, tau, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, itcpIncluded));
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type betaInit(betaInitSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type solver(solverSEXP);
+    Rcpp::traits::input_parameter< const int >::type batchSize(batchSizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ncvxHuberReg(X, Y, lambda, penalty, tau, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, itcpIncluded, standardize, timeBudget, iteBudget, betaInit, solver, batchSize));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -223,8 +272,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // cvNcvxReg
-Rcpp::List cvNcvxReg(arma::mat& X, const arma::vec& Y, Rcpp::Nullable<Rcpp::NumericVector> lSeq, int nlambda, const std::string penalty, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, int nfolds, const bool intercept, const bool itcpIncluded);
-RcppExport SEXP _ILAMM_cvNcvxReg(SEXP XSEXP, SEXP YSEXP, SEXP lSeqSEXP, SEXP nlambdaSEXP, SEXP penaltySEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP nfoldsSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP) {
+Rcpp::List cvNcvxReg(arma::mat& X, const arma::vec& Y, Rcpp::Nullable<Rcpp::NumericVector> lSeq, int nlambda, const std::string penalty, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, int nfolds, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget, const std::string cacheDir, const std::string cvType);
+RcppExport SEXP _ILAMM_cvNcvxReg(SEXP XSEXP, SEXP YSEXP, SEXP lSeqSEXP, SEXP nlambdaSEXP, SEXP penaltySEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP nfoldsSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP, SEXP cacheDirSEXP, SEXP cvTypeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -241,13 +290,18 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type nfolds(nfoldsSEXP);
     Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
     Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
-    rcpp_result_gen = Rcpp::wrap(cvNcvxReg(X, Y, lSeq, nlambda, penalty, phi0, gamma, epsilon_c, epsilon_t, iteMax, nfolds, intercept, itcpIncluded));
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type cacheDir(cacheDirSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type cvType(cvTypeSEXP);
+    rcpp_result_gen = Rcpp::wrap(cvNcvxReg(X, Y, lSeq, nlambda, penalty, phi0, gamma, epsilon_c, epsilon_t, iteMax, nfolds, intercept, itcpIncluded, standardize, timeBudget, iteBudget, cacheDir, cvType));
     return rcpp_result_gen;
 END_RCPP
 }
 // cvNcvxHuberReg
-Rcpp::List cvNcvxHuberReg(arma::mat& X, const arma::vec& Y, Rcpp::Nullable<Rcpp::NumericVector> lSeq, int nlambda, const std::string penalty, Rcpp::Nullable<Rcpp::NumericVector> tSeq, int ntau, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, int nfolds, const bool intercept, const bool itcpIncluded);
-RcppExport SEXP _ILAMM_cvNcvxHuberReg(SEXP XSEXP, SEXP YSEXP, SEXP lSeqSEXP, SEXP nlambdaSEXP, SEXP penaltySEXP, SEXP tSeqSEXP, SEXP ntauSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP nfoldsSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP) {
+Rcpp::List cvNcvxHuberReg(arma::mat& X, const arma::vec& Y, Rcpp::Nullable<Rcpp::NumericVector> lSeq, int nlambda, const std::string penalty, Rcpp::Nullable<Rcpp::NumericVector> tSeq, int ntau, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, int nfolds, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget, const std::string cacheDir, const std::string cvType);
+RcppExport SEXP _ILAMM_cvNcvxHuberReg(SEXP XSEXP, SEXP YSEXP, SEXP lSeqSEXP, SEXP nlambdaSEXP, SEXP penaltySEXP, SEXP tSeqSEXP, SEXP ntauSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP nfoldsSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP, SEXP cacheDirSEXP, SEXP cvTypeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -266,7 +320,210 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type nfolds(nfoldsSEXP);
     Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
     Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
-    rcpp_result_gen = Rcpp::wrap(cvNcvxHuberReg(X, Y, lSeq, nlambda, penalty, tSeq, ntau, phi0, gamma, epsilon_c, epsilon_t, iteMax, nfolds, intercept, itcpIncluded));
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type cacheDir(cacheDirSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type cvType(cvTypeSEXP);
+    rcpp_result_gen = Rcpp::wrap(cvNcvxHuberReg(X, Y, lSeq, nlambda, penalty, tSeq, ntau, phi0, gamma, epsilon_c, epsilon_t, iteMax, nfolds, intercept, itcpIncluded, standardize, timeBudget, iteBudget, cacheDir, cvType));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bootNcvxHuberReg
+Rcpp::List bootNcvxHuberReg(arma::mat X, const arma::vec& Y, double lambda, std::string penalty, double tau, const int nboot, const std::string method, const double sampleRate, Rcpp::Nullable<Rcpp::NumericVector> probs, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool itcpIncluded, const bool standardize, const int nthreads, const double timeBudget, const int iteBudget);
+RcppExport SEXP _ILAMM_bootNcvxHuberReg(SEXP XSEXP, SEXP YSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP tauSEXP, SEXP nbootSEXP, SEXP methodSEXP, SEXP sampleRateSEXP, SEXP probsSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP nthreadsSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type X(XSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type Y(YSEXP);
+    Rcpp::traits::input_parameter< double >::type lambda(lambdaSEXP);
+    Rcpp::traits::input_parameter< std::string >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< double >::type tau(tauSEXP);
+    Rcpp::traits::input_parameter< const int >::type nboot(nbootSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< const double >::type sampleRate(sampleRateSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type probs(probsSEXP);
+    Rcpp::traits::input_parameter< const double >::type phi0(phi0SEXP);
+    Rcpp::traits::input_parameter< const double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_c(epsilon_cSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_t(epsilon_tSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const int >::type nthreads(nthreadsSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    rcpp_result_gen = Rcpp::wrap(bootNcvxHuberReg(X, Y, lambda, penalty, tau, nboot, method, sampleRate, probs, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, itcpIncluded, standardize, nthreads, timeBudget, iteBudget));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cvNcvxRegAsync
+SEXP cvNcvxRegAsync(arma::mat X, const arma::vec& Y, Rcpp::Nullable<Rcpp::NumericVector> lSeq, int nlambda, const std::string penalty, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, int nfolds, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget);
+RcppExport SEXP _ILAMM_cvNcvxRegAsync(SEXP XSEXP, SEXP YSEXP, SEXP lSeqSEXP, SEXP nlambdaSEXP, SEXP penaltySEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP nfoldsSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type X(XSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type Y(YSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type lSeq(lSeqSEXP);
+    Rcpp::traits::input_parameter< int >::type nlambda(nlambdaSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< const double >::type phi0(phi0SEXP);
+    Rcpp::traits::input_parameter< const double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_c(epsilon_cSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_t(epsilon_tSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
+    Rcpp::traits::input_parameter< int >::type nfolds(nfoldsSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    rcpp_result_gen = Rcpp::wrap(cvNcvxRegAsync(X, Y, lSeq, nlambda, penalty, phi0, gamma, epsilon_c, epsilon_t, iteMax, nfolds, intercept, itcpIncluded, standardize, timeBudget, iteBudget));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cvNcvxHuberRegAsync
+SEXP cvNcvxHuberRegAsync(arma::mat X, const arma::vec& Y, Rcpp::Nullable<Rcpp::NumericVector> lSeq, int nlambda, const std::string penalty, Rcpp::Nullable<Rcpp::NumericVector> tSeq, int ntau, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, int nfolds, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget);
+RcppExport SEXP _ILAMM_cvNcvxHuberRegAsync(SEXP XSEXP, SEXP YSEXP, SEXP lSeqSEXP, SEXP nlambdaSEXP, SEXP penaltySEXP, SEXP tSeqSEXP, SEXP ntauSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP nfoldsSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type X(XSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type Y(YSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type lSeq(lSeqSEXP);
+    Rcpp::traits::input_parameter< int >::type nlambda(nlambdaSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type tSeq(tSeqSEXP);
+    Rcpp::traits::input_parameter< int >::type ntau(ntauSEXP);
+    Rcpp::traits::input_parameter< const double >::type phi0(phi0SEXP);
+    Rcpp::traits::input_parameter< const double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_c(epsilon_cSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_t(epsilon_tSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
+    Rcpp::traits::input_parameter< int >::type nfolds(nfoldsSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    rcpp_result_gen = Rcpp::wrap(cvNcvxHuberRegAsync(X, Y, lSeq, nlambda, penalty, tSeq, ntau, phi0, gamma, epsilon_c, epsilon_t, iteMax, nfolds, intercept, itcpIncluded, standardize, timeBudget, iteBudget));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ncvxRegAsync
+SEXP ncvxRegAsync(arma::mat X, const arma::vec& Y, const double lambda, const std::string penalty, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget, Rcpp::Nullable<Rcpp::NumericVector> betaInit, const std::string solver, const int batchSize);
+RcppExport SEXP _ILAMM_ncvxRegAsync(SEXP XSEXP, SEXP YSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP, SEXP betaInitSEXP, SEXP solverSEXP, SEXP batchSizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type X(XSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type Y(YSEXP);
+    Rcpp::traits::input_parameter< const double >::type lambda(lambdaSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< const double >::type phi0(phi0SEXP);
+    Rcpp::traits::input_parameter< const double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_c(epsilon_cSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_t(epsilon_tSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type betaInit(betaInitSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type solver(solverSEXP);
+    Rcpp::traits::input_parameter< const int >::type batchSize(batchSizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ncvxRegAsync(X, Y, lambda, penalty, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, itcpIncluded, standardize, timeBudget, iteBudget, betaInit, solver, batchSize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ncvxHuberRegAsync
+SEXP ncvxHuberRegAsync(arma::mat X, const arma::vec& Y, const double lambda, const std::string penalty, const double tau, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool itcpIncluded, const bool standardize, const double timeBudget, const int iteBudget, Rcpp::Nullable<Rcpp::NumericVector> betaInit, const std::string solver, const int batchSize);
+RcppExport SEXP _ILAMM_ncvxHuberRegAsync(SEXP XSEXP, SEXP YSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP tauSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP itcpIncludedSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP, SEXP betaInitSEXP, SEXP solverSEXP, SEXP batchSizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type X(XSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type Y(YSEXP);
+    Rcpp::traits::input_parameter< const double >::type lambda(lambdaSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< const double >::type tau(tauSEXP);
+    Rcpp::traits::input_parameter< const double >::type phi0(phi0SEXP);
+    Rcpp::traits::input_parameter< const double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_c(epsilon_cSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_t(epsilon_tSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const bool >::type itcpIncluded(itcpIncludedSEXP);
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector> >::type betaInit(betaInitSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type solver(solverSEXP);
+    Rcpp::traits::input_parameter< const int >::type batchSize(batchSizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ncvxHuberRegAsync(X, Y, lambda, penalty, tau, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, itcpIncluded, standardize, timeBudget, iteBudget, betaInit, solver, batchSize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// asyncStatus
+Rcpp::List asyncStatus(SEXP job);
+RcppExport SEXP _ILAMM_asyncStatus(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    rcpp_result_gen = Rcpp::wrap(asyncStatus(job));
+    return rcpp_result_gen;
+END_RCPP
+}
+// asyncCancel
+void asyncCancel(SEXP job);
+RcppExport SEXP _ILAMM_asyncCancel(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    asyncCancel(job);
+    return R_NilValue;
+END_RCPP
+}
+// asyncResult
+Rcpp::RObject asyncResult(SEXP job, const bool wait);
+RcppExport SEXP _ILAMM_asyncResult(SEXP jobSEXP, SEXP waitSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    Rcpp::traits::input_parameter< const bool >::type wait(waitSEXP);
+    rcpp_result_gen = Rcpp::wrap(asyncResult(job, wait));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sisNcvxHuberReg
+Rcpp::List sisNcvxHuberReg(const arma::mat& X, const arma::vec& Y, int k, const int niter, double lambda, std::string penalty, double tau, const double phi0, const double gamma, const double epsilon_c, const double epsilon_t, const int iteMax, const bool intercept, const bool standardize, const double timeBudget, const int iteBudget);
+RcppExport SEXP _ILAMM_sisNcvxHuberReg(SEXP XSEXP, SEXP YSEXP, SEXP kSEXP, SEXP niterSEXP, SEXP lambdaSEXP, SEXP penaltySEXP, SEXP tauSEXP, SEXP phi0SEXP, SEXP gammaSEXP, SEXP epsilon_cSEXP, SEXP epsilon_tSEXP, SEXP iteMaxSEXP, SEXP interceptSEXP, SEXP standardizeSEXP, SEXP timeBudgetSEXP, SEXP iteBudgetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::mat& >::type X(XSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type Y(YSEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    Rcpp::traits::input_parameter< const int >::type niter(niterSEXP);
+    Rcpp::traits::input_parameter< double >::type lambda(lambdaSEXP);
+    Rcpp::traits::input_parameter< std::string >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< double >::type tau(tauSEXP);
+    Rcpp::traits::input_parameter< const double >::type phi0(phi0SEXP);
+    Rcpp::traits::input_parameter< const double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_c(epsilon_cSEXP);
+    Rcpp::traits::input_parameter< const double >::type epsilon_t(epsilon_tSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteMax(iteMaxSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const bool >::type standardize(standardizeSEXP);
+    Rcpp::traits::input_parameter< const double >::type timeBudget(timeBudgetSEXP);
+    Rcpp::traits::input_parameter< const int >::type iteBudget(iteBudgetSEXP);
+    rcpp_result_gen = Rcpp::wrap(sisNcvxHuberReg(X, Y, k, niter, lambda, penalty, tau, phi0, gamma, epsilon_c, epsilon_t, iteMax, intercept, standardize, timeBudget, iteBudget));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -275,19 +532,31 @@ static const R_CallMethodDef CallEntries[] = {
     {"_ILAMM_sgn", (DL_FUNC) &_ILAMM_sgn, 1},
     {"_ILAMM_softThresh", (DL_FUNC) &_ILAMM_softThresh, 2},
     {"_ILAMM_cmptLambda", (DL_FUNC) &_ILAMM_cmptLambda, 3},
+    {"_ILAMM_setThreads", (DL_FUNC) &_ILAMM_setThreads, 1},
+    {"_ILAMM_unscaleBeta", (DL_FUNC) &_ILAMM_unscaleBeta, 3},
+    {"_ILAMM_scaleBeta", (DL_FUNC) &_ILAMM_scaleBeta, 3},
     {"_ILAMM_loss", (DL_FUNC) &_ILAMM_loss, 4},
     {"_ILAMM_gradLoss", (DL_FUNC) &_ILAMM_gradLoss, 6},
     {"_ILAMM_updateBeta", (DL_FUNC) &_ILAMM_updateBeta, 8},
     {"_ILAMM_cmptF", (DL_FUNC) &_ILAMM_cmptF, 5},
     {"_ILAMM_cmptPsi", (DL_FUNC) &_ILAMM_cmptPsi, 8},
     {"_ILAMM_LAMM", (DL_FUNC) &_ILAMM_LAMM, 9},
-    {"_ILAMM_ncvxReg", (DL_FUNC) &_ILAMM_ncvxReg, 11},
-    {"_ILAMM_ncvxHuberReg", (DL_FUNC) &_ILAMM_ncvxHuberReg, 12},
+    {"_ILAMM_ncvxReg", (DL_FUNC) &_ILAMM_ncvxReg, 17},
+    {"_ILAMM_ncvxHuberReg", (DL_FUNC) &_ILAMM_ncvxHuberReg, 18},
     {"_ILAMM_getIndex", (DL_FUNC) &_ILAMM_getIndex, 3},
     {"_ILAMM_getIndexComp", (DL_FUNC) &_ILAMM_getIndexComp, 3},
     {"_ILAMM_tauConst", (DL_FUNC) &_ILAMM_tauConst, 1},
-    {"_ILAMM_cvNcvxReg", (DL_FUNC) &_ILAMM_cvNcvxReg, 13},
-    {"_ILAMM_cvNcvxHuberReg", (DL_FUNC) &_ILAMM_cvNcvxHuberReg, 15},
+    {"_ILAMM_cvNcvxReg", (DL_FUNC) &_ILAMM_cvNcvxReg, 18},
+    {"_ILAMM_cvNcvxHuberReg", (DL_FUNC) &_ILAMM_cvNcvxHuberReg, 20},
+    {"_ILAMM_bootNcvxHuberReg", (DL_FUNC) &_ILAMM_bootNcvxHuberReg, 20},
+    {"_ILAMM_cvNcvxRegAsync", (DL_FUNC) &_ILAMM_cvNcvxRegAsync, 16},
+    {"_ILAMM_cvNcvxHuberRegAsync", (DL_FUNC) &_ILAMM_cvNcvxHuberRegAsync, 18},
+    {"_ILAMM_ncvxRegAsync", (DL_FUNC) &_ILAMM_ncvxRegAsync, 17},
+    {"_ILAMM_ncvxHuberRegAsync", (DL_FUNC) &_ILAMM_ncvxHuberRegAsync, 18},
+    {"_ILAMM_asyncStatus", (DL_FUNC) &_ILAMM_asyncStatus, 1},
+    {"_ILAMM_asyncCancel", (DL_FUNC) &_ILAMM_asyncCancel, 1},
+    {"_ILAMM_asyncResult", (DL_FUNC) &_ILAMM_asyncResult, 2},
+    {"_ILAMM_sisNcvxHuberReg", (DL_FUNC) &_ILAMM_sisNcvxHuberReg, 16},
     {NULL, NULL, 0}
 };
 